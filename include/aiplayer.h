@@ -0,0 +1,65 @@
+#ifndef AIPLAYER_H
+#define AIPLAYER_H
+
+#include "utils.h"
+#include "computerplayer.h"
+#include "transpositiontable.h"
+
+/// Computer opponent using alpha-beta
+/** Chooses a move with an alpha-beta search. The search is run with
+*   iterative deepening, and stops as soon as the time budget is spent :
+*   the best move of the last completed iteration is then returned.<br>
+*   Positions are evaluated by the distance of each orb to its home.
+*   Search results are kept in a transposition table, so that positions
+*   reached by different move orders (or in a previous search) are not
+*   searched twice.<br>
+*   The search can use several threads ("lazy SMP") : all threads search
+*   the same position on their own copy of the game, and only share the
+*   transposition table. The main thread picks the move.
+*/
+class AIPlayer : public ComputerPlayer
+{
+public :
+
+    /// Sets the maximum depth of the search (in plies).
+    void SetMaxDepth(uint_t uiMaxDepth);
+
+    /// Sets the memory used by the transposition table (in megabytes).
+    /** \note The table is cleared.
+    */
+    void SetHashSize(uint_t uiSizeMB);
+
+    Move Search(const GameState& mGame) override;
+
+    /// Evaluates a position.
+    /** \return The score, from the point of view of the player whose turn it is
+    */
+    static int Evaluate(const GameState& mGame);
+
+    /// Returns how many steps an orb of a given color is away from its home.
+    static int GetHomeDistance(uint_t uiColor, uint_t uiIndex);
+
+    static const int WIN_SCORE = 1000000;
+
+private :
+
+    /// What each search thread works on
+    struct SearchThread_
+    {
+        GameState mGame;
+        std::vector< std::vector<Move> > lMoveStack;
+        uint64_t uiNodes = 0;
+    };
+
+    uint_t IterativeDeepening_(SearchThread_& mThread, uint_t uiStartDepth, Move& mBestMove, int& iBestScore);
+    int AlphaBeta_(SearchThread_& mThread, uint_t uiDepth, int iAlpha, int iBeta, uint_t uiPly);
+    void SortMoves_(const GameState& mGame, std::vector<Move>& lMoveList, const Move& mFirst) const;
+
+    uint_t uiMaxDepth_ = 64;
+
+    std::vector<SearchThread_> lThreadList_;
+
+    TranspositionTable mTable_;
+};
+
+#endif
@@ -11,17 +11,29 @@ class Text;
 class Menu;
 class Board;
 class Button;
+class NetworkPlayer;
 
 class Application
 {
 public :
 
+    /// Who plays as player 2
+    enum Opponent
+    {
+        OPPONENT_HUMAN,
+        OPPONENT_ALPHABETA,
+        OPPONENT_MCTS,
+        /// Another game, over the network (see NetworkPlayer)
+        OPPONENT_NETWORK
+    };
+
     enum State
     {
         STATE_MENU,
         STATE_NEWGAME,
         STATE_SAVE,
         STATE_LOAD,
+        STATE_NETWORK,
         STATE_GAME,
         STATE_EXIT
     };
@@ -31,13 +43,32 @@ public :
 
     sf::RenderWindow* GetRenderWindow();
 
+    /// Draws on the window, and counts the draw calls.
+    void Draw(const sf::Drawable& mDrawable, const sf::RenderStates& mStates = sf::RenderStates::Default);
+
+    /// Draws vertices on the window, and counts the draw calls.
+    void Draw(const sf::Vertex* pVertices, std::size_t uiCount, sf::PrimitiveType mType,
+        const sf::RenderStates& mStates = sf::RenderStates::Default);
+
+    /// Returns the number of draw calls issued during the last frame.
+    uint_t GetDrawCallCount() const;
+
     const uint_t& GetScreenWidth() const;
     const uint_t& GetScreenHeight() const;
 
     void SetState(State mState);
 
+    /// Chooses who will play as player 2 in the next new game.
+    void SetOpponent(Opponent mOpponent);
+
+    /// Saves or loads the game on a slot, depending on the current state.
     void SaveOnSlot(const uint_t& uiSlot);
 
+    /// Starts a network game, as the host or by joining the address that was typed.
+    /** \note The game begins once the other player is connected.
+    */
+    void StartNetworkGame(bool bHost);
+
     Board* GetBoard();
 
     std::string GetLanguage() const;
@@ -45,24 +76,49 @@ public :
     static Application* GetMainApp();
 
     static const std::string CLASS_NAME;
+    static const std::string SAVE_DIRECTORY;
+    static const uint_t      SLOT_COUNT = 5;
 
 private :
 
     static Application* MAIN_APP;
 
     void Loop_();
+    void CreateBoard_();
+    void UpdateSlots_();
+    std::string GetSlotFile_(const uint_t& uiSlot) const;
     void SaveSlot_(const uint_t& uiSlot, const std::string& sName);
     void LoadSlot_(const uint_t& uiSlot);
+    void UpdateNetwork_(float fDelta);
 
     State mState_;
     sf::RenderWindow mWindow_;
     std::unique_ptr<Text> pOrbTitle_;
     std::unique_ptr<Text> pHelpText_;
     std::unique_ptr<Sprite> pCursor_;
+    std::unique_ptr<Text> pStatsText_;
     std::unique_ptr<Menu> pMainMenu_;
     std::unique_ptr<Board> pBoard_;
 
-    std::array<std::unique_ptr<Button>,5> lSaveSlotList_;
+    std::array<std::unique_ptr<Button>,SLOT_COUNT> lSaveSlotList_;
+
+    // Network game setup
+    std::unique_ptr<NetworkPlayer> pNetwork_;
+    std::unique_ptr<Button>        pHostButton_;
+    std::unique_ptr<Button>        pJoinButton_;
+    std::unique_ptr<Text>          pAddressText_;
+    std::unique_ptr<Text>          pNetworkText_;
+    std::string                    sAddress_ = "127.0.0.1";
+    std::string                    sAddressLabel_;
+    std::string                    sWaitingPlayer_;
+    std::string                    sConnecting_;
+    std::string                    sConnectionFailed_;
+
+    Opponent mOpponent_ = OPPONENT_HUMAN;
+
+    uint_t uiDrawCallCount_ = 0;
+    uint_t uiLastDrawCallCount_ = 0;
+    bool   bShowStats_ = false;
 
     uint_t uiScreenWidth_;
     uint_t uiScreenHeight_;
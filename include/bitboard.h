@@ -0,0 +1,249 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "utils.h"
+#include "point.h"
+
+#include <cstdint>
+
+using Slot = Point<int>;
+
+/// A set of slots of the board, stored as a 128 bit mask.
+/** The 10x10 board is stored row by row on the 100 lowest bits :
+*   the slot (X, Y) is mapped to the bit X + 10*Y (see GetIndex()).
+*   The remaining 28 bits are always zero.
+*/
+class BitBoard
+{
+public :
+
+    BitBoard()
+    {
+    }
+
+    BitBoard(uint64_t uiLow, uint64_t uiHigh) : uiLow_(uiLow), uiHigh_(uiHigh)
+    {
+    }
+
+    /// Returns a BitBoard with a single bit set.
+    /** \param uiIndex The index of the bit to set
+    */
+    static BitBoard FromIndex(uint_t uiIndex)
+    {
+        BitBoard mBoard;
+        mBoard.Set(uiIndex);
+        return mBoard;
+    }
+
+    void Set(uint_t uiIndex)
+    {
+        if (uiIndex < 64)
+            uiLow_ |= uint64_t(1) << uiIndex;
+        else
+            uiHigh_ |= uint64_t(1) << (uiIndex - 64);
+    }
+
+    void Reset(uint_t uiIndex)
+    {
+        if (uiIndex < 64)
+            uiLow_ &= ~(uint64_t(1) << uiIndex);
+        else
+            uiHigh_ &= ~(uint64_t(1) << (uiIndex - 64));
+    }
+
+    bool Test(uint_t uiIndex) const
+    {
+        if (uiIndex < 64)
+            return (uiLow_ >> uiIndex) & 1;
+        else
+            return (uiHigh_ >> (uiIndex - 64)) & 1;
+    }
+
+    bool IsEmpty() const
+    {
+        return (uiLow_ | uiHigh_) == 0;
+    }
+
+    /// Returns the number of bits set.
+    uint_t Count() const
+    {
+        return PopCount_(uiLow_) + PopCount_(uiHigh_);
+    }
+
+    /// Returns the index of the lowest bit set (npos if empty).
+    uint_t GetFirst() const
+    {
+        if (uiLow_)
+            return LowestBit_(uiLow_);
+        else if (uiHigh_)
+            return 64 + LowestBit_(uiHigh_);
+        else
+            return npos;
+    }
+
+    /// Returns the index of the highest bit set (npos if empty).
+    uint_t GetLast() const
+    {
+        if (uiHigh_)
+            return 64 + HighestBit_(uiHigh_);
+        else if (uiLow_)
+            return HighestBit_(uiLow_);
+        else
+            return npos;
+    }
+
+    /// Clears the lowest bit set and returns its index.
+    /** \note Must not be called on an empty BitBoard.
+    */
+    uint_t PopFirst()
+    {
+        uint_t uiIndex = GetFirst();
+        if (uiLow_)
+            uiLow_ &= uiLow_ - 1;
+        else
+            uiHigh_ &= uiHigh_ - 1;
+        return uiIndex;
+    }
+
+    uint64_t GetLow() const
+    {
+        return uiLow_;
+    }
+
+    uint64_t GetHigh() const
+    {
+        return uiHigh_;
+    }
+
+    BitBoard operator & (const BitBoard& mBoard) const
+    {
+        return BitBoard(uiLow_ & mBoard.uiLow_, uiHigh_ & mBoard.uiHigh_);
+    }
+
+    BitBoard operator | (const BitBoard& mBoard) const
+    {
+        return BitBoard(uiLow_ | mBoard.uiLow_, uiHigh_ | mBoard.uiHigh_);
+    }
+
+    BitBoard operator ^ (const BitBoard& mBoard) const
+    {
+        return BitBoard(uiLow_ ^ mBoard.uiLow_, uiHigh_ ^ mBoard.uiHigh_);
+    }
+
+    BitBoard operator ~ () const
+    {
+        return BitBoard(~uiLow_, ~uiHigh_);
+    }
+
+    void operator &= (const BitBoard& mBoard)
+    {
+        uiLow_ &= mBoard.uiLow_; uiHigh_ &= mBoard.uiHigh_;
+    }
+
+    void operator |= (const BitBoard& mBoard)
+    {
+        uiLow_ |= mBoard.uiLow_; uiHigh_ |= mBoard.uiHigh_;
+    }
+
+    void operator ^= (const BitBoard& mBoard)
+    {
+        uiLow_ ^= mBoard.uiLow_; uiHigh_ ^= mBoard.uiHigh_;
+    }
+
+    BitBoard operator << (uint_t uiShift) const
+    {
+        if (uiShift == 0)
+            return *this;
+        else if (uiShift < 64)
+            return BitBoard(uiLow_ << uiShift, (uiHigh_ << uiShift) | (uiLow_ >> (64 - uiShift)));
+        else if (uiShift < 128)
+            return BitBoard(0, uiLow_ << (uiShift - 64));
+        else
+            return BitBoard();
+    }
+
+    BitBoard operator >> (uint_t uiShift) const
+    {
+        if (uiShift == 0)
+            return *this;
+        else if (uiShift < 64)
+            return BitBoard((uiLow_ >> uiShift) | (uiHigh_ << (64 - uiShift)), uiHigh_ >> uiShift);
+        else if (uiShift < 128)
+            return BitBoard(uiHigh_ >> (uiShift - 64), 0);
+        else
+            return BitBoard();
+    }
+
+    bool operator == (const BitBoard& mBoard) const
+    {
+        return uiLow_ == mBoard.uiLow_ && uiHigh_ == mBoard.uiHigh_;
+    }
+
+    bool operator != (const BitBoard& mBoard) const
+    {
+        return uiLow_ != mBoard.uiLow_ || uiHigh_ != mBoard.uiHigh_;
+    }
+
+    /// Returns the bit index associated to a slot.
+    static uint_t GetIndex(const Slot& mSlot)
+    {
+        return uint_t(mSlot.X() + WIDTH*mSlot.Y());
+    }
+
+    /// Returns the slot associated to a bit index.
+    static Slot GetSlot(uint_t uiIndex)
+    {
+        return Slot(int(uiIndex % WIDTH), int(uiIndex / WIDTH));
+    }
+
+    static const int    WIDTH = 10;
+    static const uint_t SIZE = 100;
+
+private :
+
+#if defined(__GNUC__) || defined(__clang__)
+    static uint_t PopCount_(uint64_t uiBits)
+    {
+        return __builtin_popcountll(uiBits);
+    }
+
+    static uint_t LowestBit_(uint64_t uiBits)
+    {
+        return __builtin_ctzll(uiBits);
+    }
+
+    static uint_t HighestBit_(uint64_t uiBits)
+    {
+        return 63 - __builtin_clzll(uiBits);
+    }
+#else
+    static uint_t PopCount_(uint64_t uiBits)
+    {
+        uint_t uiCount = 0;
+        for (; uiBits; uiBits &= uiBits - 1)
+            ++uiCount;
+        return uiCount;
+    }
+
+    static uint_t LowestBit_(uint64_t uiBits)
+    {
+        uint_t uiIndex = 0;
+        while (!((uiBits >> uiIndex) & 1))
+            ++uiIndex;
+        return uiIndex;
+    }
+
+    static uint_t HighestBit_(uint64_t uiBits)
+    {
+        uint_t uiIndex = 63;
+        while (!((uiBits >> uiIndex) & 1))
+            --uiIndex;
+        return uiIndex;
+    }
+#endif
+
+    uint64_t uiLow_ = 0;
+    uint64_t uiHigh_ = 0;
+};
+
+#endif
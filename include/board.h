@@ -5,11 +5,19 @@
 
 #include "point.h"
 #include "orb.h"
+#include "tile.h"
+#include "gamestate.h"
+#include "movehistory.h"
+#include "computerplayer.h"
+#include "spritebatch.h"
 #include "application.h"
 
-class Tile;
+#include <future>
+
 class Sprite;
 class Button;
+class NetworkPlayer;
+struct NetMessage;
 
 using Vector2D = Point<float>;
 using Slot = Point<int>;
@@ -20,10 +28,10 @@ public :
 
     enum State
     {
-        STATE_PLAYER1,
-        STATE_PLAYER2,
-        STATE_VICTORY1,
-        STATE_VICTORY2
+        STATE_PLAYER1 = GameState::STATE_PLAYER1,
+        STATE_PLAYER2 = GameState::STATE_PLAYER2,
+        STATE_VICTORY1 = GameState::STATE_VICTORY1,
+        STATE_VICTORY2 = GameState::STATE_VICTORY2
     };
 
     Board(const Vector2D& mPos, Application& mApp);
@@ -34,6 +42,34 @@ public :
 
     void SetState(State mState);
 
+    /// Chooses who plays as player 2 (a human, or one of the computer players).
+    void SetOpponent(Application::Opponent mOpponent);
+
+    /// Plays against another game over the network.
+    /** \param pNetwork The connection to the other game (must be ready)
+    *   \note The turns of the other player are checked against the rules
+    *         before being played. If the connection is lost, the game
+    *         continues on this computer.
+    */
+    void SetNetwork(std::unique_ptr<NetworkPlayer> pNetwork);
+
+    /// Returns the rules and the position of the game.
+    const GameState& GetGame() const;
+
+    /// Returns the turns played so far.
+    const MoveHistory& GetHistory() const;
+
+    /// Replaces the current game by a saved one.
+    /** \param mGame     The position to play from
+    *   \param lHistory  The turns played to reach it
+    *   \param mOpponent Who plays as player 2
+    *   \note The existing orbs and tiles are reused, only moved to their new slot.
+    *         If the turns don't lead to this position, the history is dropped.
+    */
+    void LoadGame(const GameState& mGame, const std::vector<Move>& lHistory, Application::Opponent mOpponent);
+
+    static const std::string CLASS_NAME;
+
 private :
 
     void CreateGrid_();
@@ -42,15 +78,57 @@ private :
     void RenderOrbs_();
 
     void AddOrb_(const Slot& mSlot, uint_t uiType);
+    void UpdateMovedOrb_();
+    void UpdateMovements_();
+#ifdef ORB_CHECK_MOVEMENTS
+    void CheckMovements_();
+#endif
+    bool MoveOrb_(Orb* pOrb, const Slot& mSlot);
+    void RecordTurn_();
+    void StopComputer_();
+    void PlaceOrbs_(const GameState& mGame);
+
+    void SetReplay_(bool bReplay);
+    void UpdateReplay_();
+    void ShowReplayPly_(uint_t uiPly);
+
+    bool IsComputerTurn_() const;
+    void StartComputerTurn_();
+    void PlayComputerMove_();
+
+    bool IsRemoteTurn_() const;
+    void UpdateNetwork_();
+    bool PlayRemoteMove_(const NetMessage& mMessage);
     Tile* GetTile_(const Slot& mSlot);
+    Orb*  GetOrb_(const Slot& mSlot);
+    Slot  GetSlotAt_(const Vector2D& mPos) const;
+    void  AddTile_(const Slot& mSlot, Tile::Type mType);
 
     Application& mApp_;
     State mState_;
 
+    // Rules
+    GameState   mGame_;
+    MoveHistory mHistory_;
+
+    // Replay : the orbs show a past position, the game is paused
+    bool        bReplay_ = false;
+    uint_t      uiReplayPly_ = 0;
+    GameState   mReplayGame_;
+    std::string sReplay_;
+
+    // Computer opponent
+    std::unique_ptr<ComputerPlayer> pComputer_;
+    std::future<Move>               mComputerMove_;
+
+    // Network opponent
+    std::unique_ptr<NetworkPlayer> pNetwork_;
+
     Vector2D mPosition_;
 
     // GUI
     std::unique_ptr<Text> pWinText_;
+    std::unique_ptr<Text> pReplayText_;
     sf::RectangleShape      mRect_;
 
     std::unique_ptr<Text>   pPlayer1Text_;
@@ -61,14 +139,19 @@ private :
     // Grid
     std::unique_ptr<Sprite>  pNormalGrid_;
     std::unique_ptr<Sprite>  pHomeGrid_;
+    SpriteBatch              mGridBatch_;
     std::vector< std::unique_ptr<Tile> > lTileList_;
+    // Tiles indexed by BitBoard::GetIndex(), nullptr in the cut corners
+    std::array<Tile*, BitBoard::SIZE>    lSlotTileList_;
 
     // Orbs
     std::vector< std::unique_ptr<Orb> > lOrbList_;
+    SpriteBatch mOrbBatch_;
     Orb* pMouseOveredOrb_ = nullptr;
     Orb* pDraggedOrb_ = nullptr;
     Vector2D    mInitialDragPos_;
-    bool bUpdateMovements_ = false;
+    // Slots an orb entered or left since the movements were last updated
+    BitBoard mChangedSlots_;
     bool bDrag_ = false;
 
     Orb* pMovedOrb_ = nullptr;
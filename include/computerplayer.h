@@ -0,0 +1,96 @@
+#ifndef COMPUTERPLAYER_H
+#define COMPUTERPLAYER_H
+
+#include "utils.h"
+#include "gamestate.h"
+
+#include <atomic>
+#include <chrono>
+
+/// Statistics about the last search
+struct SearchInfo
+{
+    /// Depth reached by the search
+    uint_t uiDepth = 0;
+    /// Number of positions (or playouts) visited, by all threads
+    uint64_t uiNodes = 0;
+    /// Number of positions (or playouts) visited per second
+    float  fNodesPerSecond = 0.0f;
+    /// Number of threads used
+    uint_t uiThreadCount = 0;
+    /// Score of the chosen move, from the point of view of the player
+    /// (for MCTSPlayer : the chance of winning, in thousandths)
+    int    iScore = 0;
+    /// Time spent searching (in seconds)
+    float  fTime = 0.0f;
+};
+
+/// Base class of the computer opponents
+/** Holds the settings shared by all search algorithms : the time
+*   budget and the number of threads.
+*   \note Search() is blocking : run it in a separate thread if it must
+*         not stall the render loop. Stop() can be called from any thread.
+*/
+class ComputerPlayer
+{
+public :
+
+    ComputerPlayer();
+    virtual ~ComputerPlayer();
+
+    ComputerPlayer(const ComputerPlayer&) = delete;
+    ComputerPlayer& operator = (const ComputerPlayer&) = delete;
+
+    /// Sets the maximum time a search is allowed to take (in seconds).
+    void SetTimeBudget(float fTimeBudget);
+    float GetTimeBudget() const;
+
+    /// Sets the number of threads used for searching.
+    /** \note Defaults to the number of cores of the machine.
+    */
+    void SetThreadCount(uint_t uiThreadCount);
+    uint_t GetThreadCount() const;
+
+    /// Returns the best move found for the player whose turn it is.
+    /** \param mGame The game to play (no orb must have been moved this turn)
+    *   \note The game must not be over.
+    */
+    virtual Move Search(const GameState& mGame) = 0;
+
+    /// Aborts the current search as soon as possible.
+    /** \note If no search is running, the next one stops at once :
+    *         call ClearStop() before starting a new search.
+    */
+    void Stop();
+
+    /// Allows the next search to run (cancels a previous Stop()).
+    /** \note Call it before starting a search in another thread, so
+    *         that a Stop() sent before the search begins is not lost.
+    */
+    void ClearStop();
+
+    const SearchInfo& GetLastSearchInfo() const;
+
+protected :
+
+    /// Starts the timer and resets the statistics.
+    void StartSearch_();
+
+    /// Fills the timing statistics of the search.
+    void EndSearch_();
+
+    bool IsTimeOut_() const;
+
+    float  fTimeBudget_ = 1.0f;
+    uint_t uiThreadCount_ = 1;
+
+    /// Checked by the search (also set when the time is out)
+    std::atomic<bool> bStop_;
+    /// Set by Stop(), cleared by ClearStop()
+    std::atomic<bool> bStopRequested_;
+    std::chrono::steady_clock::time_point mStartTime_;
+
+    SearchInfo mLastInfo_;
+};
+
+#endif
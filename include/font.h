@@ -2,51 +2,127 @@
 #define FONT_H
 
 #include "utils.h"
-#include "point.h"
+#include "mappedfile.h"
 
 #include <SFML/Graphics.hpp>
 
+#include <unordered_map>
+
+typedef struct FT_FaceRec_* FT_Face;
+
 struct CharacterInfo
 {
-    uint_t uiCodePoint = 0;
-
-    float fU1 = 0.0, fV1 = 0.0;
-    float fU2 = 0.0, fV2 = 0.0;
+    /// Position of the character's cell in the texture (in pixels)
+    sf::IntRect mRect;
 
-    std::map< uchar_t, Point<float> > lKerningInfo;
+    /// 'false' until the character is rendered
+    bool bLoaded = false;
 };
 
 /// Manages font creation
+/** Characters are rendered on first use, and packed in rows into a
+*   texture that grows as needed. Any code point that the font file
+*   contains can be displayed.<br>
+*   The rendered characters can be saved to a cache file, and loaded
+*   back on the next launch : the font file is then only opened if a
+*   character is missing from the cache.<br>
+*   Metrics and kerning of the first 256 code points are stored in
+*   flat arrays, so that measuring text doesn't chase pointers. Other
+*   code points go to hash tables.
+*/
 class Font
 {
 public :
 
+    /// Prepares a font.
+    /** \param sFontFile The path to the .ttf file
+    *   \param uiSize    The size at which to render the font
+    *   \note The font file is opened on first use, with the FreeType
+    *         library of the FontManager.
+    */
     Font(const std::string& sFontFile, const uint_t& uiSize);
 
     ~Font();
 
-    std::array<float,4> GetCharacterUVs(const uchar_t& ucChar) const;
+    /// Returns the cell of a character in the texture (in pixels).
+    /** \note The position of a character never changes once it is
+    *         rendered, even if the texture has to grow.
+    */
+    const sf::IntRect& GetCharacterRect(const uint_t& uiChar) const;
 
-    float GetCharacterWidth(const uchar_t& ucChar) const;
+    float GetCharacterWidth(const uint_t& uiChar) const;
 
-    float GetCharacterKerning(const uchar_t& uiChar1, const uchar_t& uiChar2) const;
+    float GetCharacterKerning(const uint_t& uiChar1, const uint_t& uiChar2) const;
 
+    /// Returns the texture holding all the characters rendered so far.
+    /** \note Newly rendered characters are uploaded here.
+    */
     sf::Texture* GetTexture();
 
     float GetTextureWidth() const;
 
     float GetTextureHeight() const;
 
+    /// Loads the characters rendered during a previous launch.
+    /** \param sCacheFile The cache file, written by SaveCache()
+    *   \param iFileTime  The modification time of the font file
+    *   \return 'false' if the cache is missing, or doesn't match this font
+    *   \note Must be called before any character is used. The cache file
+    *         is memory mapped, and its pixels are uploaded as is.
+    */
+    bool LoadCache(const std::string& sCacheFile, long long iFileTime);
+
+    /// Saves the rendered characters, if any was added since LoadCache().
+    /** \param sCacheFile The cache file
+    *   \param iFileTime  The modification time of the font file
+    *   \return 'false' if the file could not be written
+    *   \note The file is first written under another name, then renamed,
+    *         so that an interrupted write never leaves a broken cache.
+    */
+    bool SaveCache(const std::string& sCacheFile, long long iFileTime) const;
+
     static const std::string CLASS_NAME;
 
+    /// Number of code points stored in the flat tables
+    static const uint_t TABLE_SIZE = 256;
+
 private :
 
-    std::map<uchar_t, CharacterInfo> lCharacterList_;
+    void OpenFace_() const;
+    CharacterInfo& GetCharacter_(uint_t uiChar) const;
+    void RenderCharacter_(uint_t uiChar, CharacterInfo& mCI) const;
+    float LoadKerning_(uint_t uiChar1, uint_t uiChar2) const;
+    bool Reserve_(uint_t uiWidth, uint_t uiHeight, uint_t& uiX, uint_t& uiY) const;
+    const uchar_t* GetPixels_() const;
 
-    sf::Texture mTexture_;
-    float fTextureWidth_ = 0.0;
-    float fTextureHeight_ = 0.0;
+    std::string sFontFile_;
+    uint_t uiSize_ = 0;
 
+    // Opened on demand
+    mutable FT_Face mFace_ = nullptr;
+
+    mutable int    iAscender_ = 0;
+    mutable uint_t uiLineHeight_ = 0;
+    uint_t uiSpacing_ = 0;
+
+    // Filled on demand
+    mutable std::array<CharacterInfo, TABLE_SIZE>       lCharacterTable_;
+    mutable std::unordered_map<uint_t, CharacterInfo>   lExtraCharacterList_;
+
+    // Indexed by uiChar1*TABLE_SIZE + uiChar2, NaN if not known yet
+    mutable std::vector<float>                          lKerningTable_;
+    mutable std::unordered_map<uint64_t, float>         lExtraKerningList_;
+
+    // Pixels come from the cache file until a new character is rendered
+    mutable MappedFile mCache_;
+    mutable sf::Image  mImage_;
+    mutable uint_t uiTextureWidth_ = 0, uiTextureHeight_ = 0;
+    mutable uint_t uiPenX_ = 0, uiPenY_ = 0;
+    mutable uint_t uiRowHeight_ = 0;
+    mutable bool   bTextureDirty_ = false;
+    mutable bool   bModified_ = false;
+
+    sf::Texture mTexture_;
 };
 
 #endif
@@ -5,6 +5,7 @@
 #include "manager.h"
 
 class Font;
+typedef struct FT_LibraryRec_* FT_Library;
 
 /// Manages font creation
 class FontManager : public Manager<FontManager>
@@ -16,20 +17,33 @@ public :
     /** \param sFontFile The path to the .tff file
     *   \param uiSize    The size at which to render the font
     *   \note This function will create the font if it doens't exists,
-    *         or return a pointer to it if has already been created.
+    *         or return a pointer to it if has already been created.<br>
+    *         The characters rendered during the previous launch are
+    *         loaded from the cache directory, if the font file hasn't
+    *         changed since. The cache is updated when the FontManager
+    *         is deleted.
     */
     Font*  GetFont(const std::string& sFontFile, const uint_t& uiSize);
 
+    /// Returns the FreeType library shared by all the fonts.
+    /** \note It is initialized on first use.
+    */
+    FT_Library GetLibrary();
+
     /// Returns the name of the default font.
     /** \return The name of the default font
     *   \note This value is read from config files.
     */
     const std::string& GetDefaultFont() const;
 
+    /// Enables or disables the font cache (enabled by default).
+    void SetCacheEnabled(bool bEnabled);
+
     /// Reads the configuration files.
     void         ReadConfig();
 
     static const std::string CLASS_NAME;
+    static const std::string CACHE_DIRECTORY;
 
 protected :
 
@@ -62,9 +76,19 @@ protected :
 
 private :
 
+    struct FontEntry_
+    {
+        std::unique_ptr<Font> pFont;
+        std::string sCacheFile;
+        long long   iFileTime = 0;
+    };
+
     std::string sDefaultFont_;
+    bool bCacheEnabled_ = true;
+
+    FT_Library mLibrary_ = nullptr;
 
-    std::map< std::string, std::unique_ptr<Font> > lFontList_;
+    std::map< std::string, FontEntry_ > lFontList_;
 };
 
 #endif
@@ -0,0 +1,118 @@
+#ifndef GAMESERVER_H
+#define GAMESERVER_H
+
+#include "utils.h"
+#include "netprotocol.h"
+
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+/// Hosts many network games at once, without any rendering
+/** Clients speak the protocol described in NetProtocol : each one sends a
+*   HELLO with the player it wants to control, and is paired in arrival
+*   order with a client waiting for the other player. The server then
+*   answers both with a HELLO (it speaks for the other player), and relays
+*   their turns after checking them against the rules. A finished game
+*   restarts from the initial layout, with the same players.<br>
+*   The calling thread accepts and pairs the clients (Run()). Each match is
+*   then handed to one of the workers, which run their own event loop
+*   (epoll) over the sockets of their matches.<br>
+*   A match is a GameState plus two connections with fixed-size buffers
+*   (about 1 kB in all) : nothing is allocated while turns are played.
+*   \note Uses epoll : Linux only.
+*/
+class GameServer
+{
+public :
+
+    /// Counters since the server started
+    struct Statistics
+    {
+        /// Turns relayed
+        uint64_t uiMoves = 0;
+        /// Games played to the end
+        uint64_t uiGames = 0;
+        /// Matches started
+        uint64_t uiMatches = 0;
+        /// Matches still running
+        uint64_t uiActiveMatches = 0;
+        /// Matches closed because a client broke the rules or the protocol
+        uint64_t uiRejected = 0;
+    };
+
+    /// Creates a server.
+    /** \param uiWorkerCount The number of threads running the matches
+    */
+    explicit GameServer(uint_t uiWorkerCount);
+    ~GameServer();
+
+    GameServer(const GameServer&) = delete;
+    GameServer& operator = (const GameServer&) = delete;
+
+    /// Listens to a port, and starts the workers.
+    /** \return 'false' if the port cannot be used
+    */
+    bool Start(unsigned short uiPort);
+
+    /// Accepts and pairs clients until Stop() is called.
+    /** \param fReportPeriod Time between two reports of the statistics in the log (in seconds)
+    */
+    void Run(float fReportPeriod);
+
+    /// Makes Run() return as soon as possible.
+    /** \note Can be called from any thread, or from a signal handler.
+    */
+    void Stop();
+
+    Statistics GetStatistics() const;
+
+    static const std::string CLASS_NAME;
+    static const uint_t IN_BUFFER_SIZE = 64;
+    static const uint_t OUT_BUFFER_SIZE = 256;
+
+private :
+
+    struct Connection_;
+    struct Match_;
+    struct Worker_;
+
+    /// A client waiting for its HELLO to be read, or for an opponent
+    struct PendingClient_
+    {
+        int    iSocket = -1;
+        /// The player it asked for (npos until its HELLO is received)
+        uint_t uiPlayer = npos;
+        uint_t uiSize = 0;
+        std::array<uchar_t, IN_BUFFER_SIZE> lBuffer;
+    };
+
+    void AcceptClients_();
+    void ReadPendingClient_(int iSocket);
+    void DropPendingClient_(int iSocket);
+    void StartMatch_(int iSocket1, int iSocket2);
+
+    void RunWorker_(Worker_& mWorker);
+    void AddNewMatches_(Worker_& mWorker);
+    void Read_(Worker_& mWorker, Connection_& mConnection);
+    bool Play_(Worker_& mWorker, Connection_& mConnection, const NetMessage& mMessage);
+    bool Send_(Worker_& mWorker, Connection_& mConnection, const NetMessage& mMessage);
+    bool Flush_(Worker_& mWorker, Connection_& mConnection);
+    void Reject_(Worker_& mWorker, Match_& mMatch);
+    void CloseMatch_(Worker_& mWorker, Match_& mMatch);
+
+    std::atomic<bool> bStop_;
+
+    int iListenSocket_ = -1;
+    int iAcceptEpoll_ = -1;
+
+    std::unordered_map<int, PendingClient_> lPendingList_;
+    /// Sockets of the clients waiting for an opponent, for each player
+    std::array<std::deque<int>, 2> lWaitingList_;
+
+    std::vector< std::unique_ptr<Worker_> > lWorkerList_;
+    uint_t uiNextWorker_ = 0;
+    uint64_t uiMatches_ = 0;
+};
+
+#endif
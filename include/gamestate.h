@@ -0,0 +1,176 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include "utils.h"
+#include "bitboard.h"
+
+/// A complete turn : one orb going from a slot to another.
+struct Move
+{
+    Move()
+    {
+    }
+
+    Move(uint_t uiFrom, uint_t uiTo) : uiFrom(uiFrom), uiTo(uiTo)
+    {
+    }
+
+    bool operator == (const Move& mMove) const
+    {
+        return uiFrom == mMove.uiFrom && uiTo == mMove.uiTo;
+    }
+
+    bool operator != (const Move& mMove) const
+    {
+        return uiFrom != mMove.uiFrom || uiTo != mMove.uiTo;
+    }
+
+    /// Bit index of the starting slot
+    uchar_t uiFrom = 0;
+    /// Bit index of the destination slot
+    uchar_t uiTo = 0;
+};
+
+/// Holds the rules and the state of a game, without any rendering.
+/** Orbs are identified by their index (0 to 47), in the order
+*   they are created in the initial layout.<br>
+*   The game can be driven step by step like the GUI does
+*   (MoveOrb(), CancelMove(), EndTurn()), or turn by turn
+*   for searching (GenerateMoves(), PlayMove(), UndoMove()).
+*/
+class GameState
+{
+public :
+
+    /// Orb colors (same order as Orb::Type)
+    enum Color
+    {
+        BLUE = 0,
+        RED,
+        GREEN,
+        PINK
+    };
+
+    enum State
+    {
+        STATE_PLAYER1,
+        STATE_PLAYER2,
+        STATE_VICTORY1,
+        STATE_VICTORY2
+    };
+
+    static const uint_t ORB_COUNT = 48;
+    static const uint_t ORBS_PER_COLOR = 12;
+
+    /// Creates a game with the initial layout.
+    GameState();
+
+    /// Puts back all the orbs in the initial layout, and gives the hand to player 1.
+    void Reset();
+
+    /// Puts the orbs on given slots (used to load a saved game).
+    /** \param lOrbSlotList  The bit index of the slot of each orb
+    *   \param mState        Whose turn it is, or who won
+    *   \param uiMovedOrb    The orb moved during this turn (npos if none)
+    *   \param uiInitialSlot The bit index of the slot where the moved orb started
+    *   \return 'false' if this is not a valid position (the game is then reset)
+    *   \note The color of each orb is given by its index, as in Reset().
+    */
+    bool SetLayout(const std::array<uchar_t, ORB_COUNT>& lOrbSlotList, State mState,
+        uint_t uiMovedOrb, uint_t uiInitialSlot);
+
+    State GetState() const;
+    bool IsOver() const;
+
+    /// Returns the player whose turn it is (0 or 1).
+    uint_t GetPlayer() const;
+
+    /// Returns the Zobrist hash of the orb layout and of the player to move.
+    /** \note The hash is updated incrementally every time an orb moves.
+    */
+    uint64_t GetHash() const;
+
+    uint_t GetOrbAt(const Slot& mSlot) const;
+    uint_t GetOrbAt(uint_t uiIndex) const;
+    Slot GetOrbSlot(uint_t uiOrb) const;
+    uint_t GetOrbIndex(uint_t uiOrb) const;
+    Color GetOrbColor(uint_t uiOrb) const;
+    bool IsWellPlaced(uint_t uiOrb) const;
+
+    const BitBoard& GetOccupied() const;
+    const BitBoard& GetColorMask(Color mColor) const;
+
+    /// Returns the mask of the orbs controlled by a player.
+    BitBoard GetPlayerMask(uint_t uiPlayer) const;
+
+    /// Checks if the current player is allowed to move this orb.
+    /** \note Only one orb can be moved per turn.
+    */
+    bool CanPlay(uint_t uiOrb) const;
+
+    /// Returns all the slots an orb can go to in the current turn.
+    /** \note If the orb has already been moved during this turn, this
+    *         includes its initial slot.
+    */
+    BitBoard GetMovements(uint_t uiOrb) const;
+
+    /// Moves an orb, if the rules allow it.
+    /** \param uiOrb The orb to move
+    *   \param mSlot The destination
+    *   \return 'false' if the move is not allowed
+    *   \note The orb can be moved again until the end of the turn, and
+    *         moving it back to its initial slot cancels the move.
+    */
+    bool MoveOrb(uint_t uiOrb, const Slot& mSlot);
+
+    /// Puts back the orb moved during this turn (if any) to its initial slot.
+    void CancelMove();
+
+    /// Returns the orb moved during this turn (npos if none).
+    uint_t GetMovedOrb() const;
+
+    /// Returns the slot where the moved orb started this turn.
+    Slot GetInitialSlot() const;
+
+    /// Gives the hand to the other player.
+    void EndTurn();
+
+    /// Lists all the complete turns the current player can play.
+    /** \param lMoveList The list to fill (it is cleared first)
+    */
+    void GenerateMoves(std::vector<Move>& lMoveList) const;
+
+    /// Plays a complete turn and gives the hand to the other player.
+    /** \note No check is done : the move must come from GenerateMoves(),
+    *         and no orb must have been moved with MoveOrb() this turn.
+    */
+    void PlayMove(const Move& mMove);
+
+    /// Cancels a turn played with PlayMove().
+    void UndoMove(const Move& mMove);
+
+private :
+
+    void AddOrb_(const Slot& mSlot, Color mColor);
+    void MoveOrb_(uint_t uiOrb, uint_t uiTo);
+    void UpdateVictory_();
+    void SetState_(State mState);
+
+    static const uchar_t NO_ORB = 0xFF;
+
+    State mState_ = STATE_PLAYER1;
+    uint64_t uiHash_ = 0;
+
+    BitBoard mOccupied_;
+    std::array<BitBoard, 4> lColorMaskList_;
+
+    std::array<uchar_t, ORB_COUNT>    lOrbSlotList_;
+    std::array<uchar_t, ORB_COUNT>    lOrbColorList_;
+    std::array<uchar_t, BitBoard::SIZE> lSlotOrbList_;
+
+    uint_t uiOrbCount_ = 0;
+    uint_t uiMovedOrb_ = npos;
+    uint_t uiInitialSlot_ = 0;
+};
+
+#endif
@@ -5,6 +5,7 @@
 #include "manager.h"
 
 #include <SFML/Window.hpp>
+#include <bitset>
 
 enum MouseState
 {
@@ -125,7 +126,9 @@ enum KeyCode
     KEY_F13,
     KEY_F14,
     KEY_F15,
-    KEY_PAUSE
+    KEY_PAUSE,
+
+    KEY_COUNT         ///< Number of keys (not a key)
 };
 
 /// Handles inputs (keyboard and mouse)
@@ -150,25 +153,65 @@ public :
 
     void            NotifyMouseWheelMoved(const int& iMovement);
 
+    /// Records a mouse movement (sf::Event::MouseMoved).
+    /** \param iX The new horizontal position of the mouse
+    *   \param iY The new vertical position of the mouse
+    *   \note Only used in high rate mode (see SetHighRateMouse()).
+    */
+    void            NotifyMouseMoved(int iX, int iY);
+
+    /// Records where a mouse button was pressed or released.
+    /** \param mID The button (sf::Event::MouseButtonPressed/Released)
+    *   \param iX  The horizontal position of the mouse
+    *   \param iY  The vertical position of the mouse
+    *   \note Only used in high rate mode (see SetHighRateMouse()).
+    */
+    void            NotifyMouseButton(MouseButton mID, int iX, int iY);
+
     /// Updates input (keyboard and mouse).
     void            Update(float fDelta);
 
+    /// Returns the ID of an input group, to use instead of its name.
+    /** \param sGroupName The name of the group
+    *   \return The ID of the group (registered on first call)
+    *   \note Get the ID once (when creating a widget, for example) and use
+    *         the functions taking an ID every frame : they do not compare
+    *         any string.
+    */
+    uint_t          GetClickGroupID(const std::string& sGroupName);
+
     /// Allows a particular input group to receive click events.
     /** \param sGroupName The name of the group to enable
     */
     void            AllowClicks(const std::string& sGroupName);
 
+    /// Allows a particular input group to receive click events.
+    /** \param uiGroupID The ID of the group to enable (see GetClickGroupID())
+    */
+    void            AllowClicks(uint_t uiGroupID);
+
     /// Prevents a particular input group from receiving click events.
     /** \param sGroupName The name of the group to disable
     */
     void            BlockClicks(const std::string& sGroupName);
 
+    /// Prevents a particular input group from receiving click events.
+    /** \param uiGroupID The ID of the group to disable (see GetClickGroupID())
+    */
+    void            BlockClicks(uint_t uiGroupID);
+
     /// Checks if a particular input group can receive click events.
     /** \param sGroupName The name of the group to check
     *   \return 'true' if the group can receive click events
     */
     bool          CanGroupReceiveClicks(const std::string& sGroupName) const;
 
+    /// Checks if a particular input group can receive click events.
+    /** \param uiGroupID The ID of the group to check (see GetClickGroupID())
+    *   \return 'true' if the group can receive click events
+    */
+    bool          CanGroupReceiveClicks(uint_t uiGroupID) const;
+
     /// Makes sure a particular input group receives click events.
     /** \param sGroupName The name of the group to force
     *   \param bForce     'true' to force input
@@ -177,6 +220,12 @@ public :
     */
     void            ForceClicksAllowed(const std::string& sGroupName, bool bForce);
 
+    /// Makes sure a particular input group receives click events.
+    /** \param uiGroupID The ID of the group to force (see GetClickGroupID())
+    *   \param bForce    'true' to force input
+    */
+    void            ForceClicksAllowed(uint_t uiGroupID, bool bForce);
+
     /// Checks if a key has been pressed.
     /** \param bForce 'true' to bypass focus (see SetFocus())
     *   \return 'true' if a key has been pressed
@@ -321,6 +370,22 @@ public :
     */
     float  GetMousePosY() const;
 
+    /// Returns the horizontal position of the mouse when a button was last pressed or released.
+    /** \param mID The button
+    *   \return The horizontal position of the mouse at that time
+    *   \note In high rate mode, this is the position of the button event :
+    *         at low frame rates, the mouse can be far from it at the next
+    *         frame. Else, this is the position read on that frame.
+    */
+    float  GetMouseButtonPosX(MouseButton mID) const;
+
+    /// Returns the vertical position of the mouse when a button was last pressed or released.
+    /** \param mID The button
+    *   \return The vertical position of the mouse at that time
+    *   \note See GetMouseButtonPosX().
+    */
+    float  GetMouseButtonPosY(MouseButton mID) const;
+
     /// Returns the horizontal position variation of the mouse.
     /** \return The horizontal position variation of the mouse
     *   \note This function returns values just as they are given
@@ -349,6 +414,20 @@ public :
     */
     float  GetMouseDY() const;
 
+    /// Returns the smoothed horizontal position variation of the mouse.
+    /** \return The smoothed horizontal position variation of the mouse
+    *   \note This is the mouse movement averaged over the buffer duration
+    *         (see SetMouseBufferDuration()), scaled to the last frame, and
+    *         with the game's sensibility factor applied.
+    */
+    float  GetMouseSmoothDX() const;
+
+    /// Returns the smoothed vertical position variation of the mouse.
+    /** \return The smoothed vertical position variation of the mouse
+    *   \note See GetMouseSmoothDX().
+    */
+    float  GetMouseSmoothDY() const;
+
     /// Returns the rolling ammount of the mouse wheel.
     /** \return The rolling ammount of the mouse wheel
     */
@@ -383,6 +462,22 @@ public :
     */
     float GetMouseBufferDuration() const;
 
+    /// Sets whether every mouse movement should be recorded.
+    /** \param bHighRate 'true' to record every movement
+    *   \note By default, the mouse position is read once per frame. In high
+    *         rate mode, the position is taken from the mouse movement events
+    *         (see NotifyMouseMoved()), and each of them is buffered : the
+    *         mouse movement stays accurate even at low frame rates. The
+    *         position of the button events is also kept (see
+    *         GetMouseButtonPosX()).
+    */
+    void            SetHighRateMouse(bool bHighRate);
+
+    /// Checks if every mouse movement is recorded.
+    /** \return 'true' if every mouse movement is recorded
+    */
+    bool            IsHighRateMouse() const;
+
     /// Sets the mouse movement factor.
     /** \param fMouseSensibility The new movement factor
     *   \note Increase this parameter to make mouse controlled movement faster.
@@ -407,6 +502,12 @@ public :
 
     static const std::string CLASS_NAME;
 
+    /// Maximum number of input groups
+    static const uint_t MAX_CLICK_GROUPS = 64;
+
+    /// Maximum number of buffered mouse movements
+    static const uint_t MOUSE_HISTORY_SIZE = 256;
+
 protected :
 
     /// Default constructor.
@@ -438,15 +539,29 @@ protected :
 
 private :
 
+    /// A buffered mouse movement
+    struct MouseSample_
+    {
+        double dTime = 0.0;
+        float fDX = 0.0f, fDY = 0.0f;
+    };
+
+    void PushMouseSample_(float fDX, float fDY);
+    void ExpireMouseSamples_();
+
     sf::Window* pWindow_;
 
     bool bFocus_ = false;
 
-    // Keyboard
-    std::map<KeyCode, float> lKeyDelay_;
-    std::map<KeyCode, bool>  lKeyLong_;
-    std::map<KeyCode, bool>  lKeyBuf_;
-    std::map<KeyCode, bool>  lKeyBufOld_;
+    // Keyboard : one bit per KeyCode
+    typedef std::bitset<KEY_COUNT> KeySet_;
+
+    std::array<float, KEY_COUNT> lKeyDelay_;
+    KeySet_ mKeyLong_;
+    KeySet_ mKeyBuf_;
+    KeySet_ mKeyBufOld_;
+    KeySet_ mKeyPressed_;
+    KeySet_ mKeyReleased_;
 
     bool bCtrlPressed_ = false;
     bool bShiftPressed_ = false;
@@ -466,15 +581,29 @@ private :
     std::array<bool,3>     lMouseBufOld_;
     std::array<MouseState,3> lMouseState_;
 
-    std::map<std::string, bool> lClickGroupList_;
-    std::map<std::string, bool> lForcedClickGroupList_;
+    // Click groups : one bit per group ID
+    std::map<std::string, uint_t>      lClickGroupIDList_;
+    std::bitset<MAX_CLICK_GROUPS> mBlockedClickGroups_;
+    std::bitset<MAX_CLICK_GROUPS> mForcedClickGroups_;
 
     float fMX_ = 0.0, fMY_ = 0.0;
     float fDMX_ = 0.0, fDMY_ = 0.0;
     float fRawDMX_ = 0.0, fRawDMY_ = 0.0;
     float fMouseSensibility_ = 0.0;
+    float fSmoothDMX_ = 0.0, fSmoothDMY_ = 0.0;
     float fMouseHistoryMaxLength_ = 0.0;
-    std::vector< std::pair< float, std::array<float,3> > > lMouseHistory_;
+    bool  bHighRateMouse_ = false;
+    float fEventMX_ = 0.0, fEventMY_ = 0.0;
+    bool  bMouseMoved_ = false;
+    std::array<float,3> lButtonMX_, lButtonMY_;
+    std::array<bool,3>  lButtonEvent_;
+
+    // Ring buffer of mouse movements, with their running sum
+    std::array<MouseSample_, MOUSE_HISTORY_SIZE> lMouseHistory_;
+    uint_t uiMouseHistoryStart_ = 0;
+    uint_t uiMouseHistoryCount_ = 0;
+    float  fMouseHistoryDX_ = 0.0, fMouseHistoryDY_ = 0.0;
+    double dTime_ = 0.0;
     int   iMWheel_ = 0;
     bool  bWheelRolled_ = false;
     std::string   sMouseButton_;
@@ -3,26 +3,129 @@
 
 #include "utils.h"
 
+/// Importance of a log message
+enum LogLevel
+{
+    LOG_TRACE = 0,
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARNING,
+    LOG_ERROR
+};
+
+/// Messages below this level are removed at compile time (see the ORB_LOG_LEVEL CMake option).
+#ifndef ORB_LOG_LEVEL
+#define ORB_LOG_LEVEL 1
+#endif
+
+/// Sets the minimum level of the messages to write (default : LOG_INFO).
+/** \note Messages below this level are not formatted at all.
+*/
+void SetLogLevel(LogLevel mLevel);
+
+/// Returns the minimum level of the messages to write.
+LogLevel GetLogLevel();
+
+/// Checks if messages of a given level are written.
+bool IsLogEnabled(LogLevel mLevel);
+
+/// Also writes the log as JSON lines in a file (one object per message).
+/** \param sFile The file to write (empty to stop writing JSON)
+*   \return 'false' if the file cannot be opened
+*   \note Each line holds the time (seconds since the log started), the level,
+*         the thread (numbered in order of their first message), the class and
+*         the message.
+*/
+bool SetLogJSONFile(const std::string& sFile);
+
+/// Queues a message for writing, with its level and its class (can be empty).
+void WriteLog(LogLevel mLevel, const std::string& sClass, const std::string& sMessage);
+
 void Log(const std::string& sMessage, bool bTimeStamps, uint_t uiOffset);
 
 template<class T> void Log(const T& mObject, bool bTimeStamps = true, uint_t uiOffset = 0)
 {
-    Log(ToString(mObject), bTimeStamps, uiOffset);
+    if (LOG_INFO >= ORB_LOG_LEVEL && IsLogEnabled(LOG_INFO))
+        Log(ToString(mObject), bTimeStamps, uiOffset);
 }
 
-void Error(const std::string& sClass, const std::string& sMessage);
-void Warning(const std::string& sClass, const std::string& sMessage);
+/// Waits until all the messages logged by this thread are written to the console and the log file.
+void FlushLog();
 
-template<class T, class ... Args>
-void Error(const std::string& sClass, const std::string& sMessage, const T& mObject, const Args& ... args)
+inline void AppendLogValue(std::string& sMessage, const std::string& sValue)
+{
+    sMessage += sValue;
+}
+
+inline void AppendLogValue(std::string& sMessage, const char* sValue)
+{
+    sMessage += sValue;
+}
+
+template<class T>
+void AppendLogValue(std::string& sMessage, const T& mObject)
+{
+    sMessage += ToString(mObject);
+}
+
+inline void AppendLog(std::string&)
 {
-    Error(sClass, sMessage+ToString(mObject), args...);
 }
 
 template<class T, class ... Args>
-void Warning(const std::string& sClass, const std::string& sMessage, const T& mObject, const Args& ... args)
+void AppendLog(std::string& sMessage, const T& mObject, const Args& ... args)
+{
+    AppendLogValue(sMessage, mObject);
+    AppendLog(sMessage, args...);
+}
+
+/// Writes a message made of all the arguments, if its level is enabled.
+/** \note The arguments are only converted to a string if the message is
+*         written, and the whole call is removed at compile time if the
+*         level is below ORB_LOG_LEVEL : pass values as separate arguments
+*         rather than building a string.<br>
+*         The class can be a std::string or a string literal.
+*/
+template<LogLevel mLevel, class C, class ... Args>
+void LogMessage(const C& sClass, const Args& ... args)
+{
+    if (mLevel < ORB_LOG_LEVEL || !IsLogEnabled(mLevel))
+        return;
+
+    std::string sMessage;
+    AppendLog(sMessage, args...);
+    WriteLog(mLevel, sClass, sMessage);
+}
+
+/// Writes an error, and waits until it is written (see FlushLog()).
+template<class C, class ... Args>
+void Error(const C& sClass, const Args& ... args)
+{
+    LogMessage<LOG_ERROR>(sClass, args...);
+}
+
+template<class C, class ... Args>
+void Warning(const C& sClass, const Args& ... args)
+{
+    LogMessage<LOG_WARNING>(sClass, args...);
+}
+
+template<class C, class ... Args>
+void Info(const C& sClass, const Args& ... args)
+{
+    LogMessage<LOG_INFO>(sClass, args...);
+}
+
+template<class C, class ... Args>
+void Debug(const C& sClass, const Args& ... args)
+{
+    LogMessage<LOG_DEBUG>(sClass, args...);
+}
+
+template<class C, class ... Args>
+void Trace(const C& sClass, const Args& ... args)
 {
-    Warning(sClass, sMessage+ToString(mObject), args...);
+    LogMessage<LOG_TRACE>(sClass, args...);
 }
 
 #endif
@@ -0,0 +1,51 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include "utils.h"
+
+/// Read-only view of the content of a whole file
+/** On POSIX systems, the file is mapped in memory with mmap() : pages
+*   are only read from the disk when they are accessed. Elsewhere,
+*   the file is simply read into a buffer.
+*/
+class MappedFile
+{
+public :
+
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator = (const MappedFile&) = delete;
+
+    /// Opens a file.
+    /** \param sFile The file to open
+    *   \return 'false' if the file cannot be read
+    *   \note The previous file (if any) is closed first.
+    */
+    bool Open(const std::string& sFile);
+
+    /// Releases the file.
+    void Close();
+
+    bool IsOpen() const;
+
+    /// Returns the content of the file.
+    /** \note The pointer is valid until Close() is called.
+    */
+    const uchar_t* GetData() const;
+
+    /// Returns the size of the file (in bytes).
+    uint_t GetSize() const;
+
+private :
+
+    const uchar_t* pData_ = nullptr;
+    uint_t uiSize_ = 0;
+
+#ifndef POSIX
+    std::vector<uchar_t> lBuffer_;
+#endif
+};
+
+#endif
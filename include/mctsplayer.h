@@ -0,0 +1,90 @@
+#ifndef MCTSPLAYER_H
+#define MCTSPLAYER_H
+
+#include "utils.h"
+#include "computerplayer.h"
+
+#include <mutex>
+#include <random>
+
+/// Computer opponent using Monte Carlo Tree Search
+/** Grows a game tree by repeatedly choosing a path with the UCT formula,
+*   adding one node at its end, and estimating the value of this node with
+*   a short playout. Playouts are guided by the distance of the orbs to
+*   their home, and are evaluated when they reach their maximum length
+*   without a winner. The move that was explored the most is played.<br>
+*   Playouts run in parallel on several threads that share the tree.
+*   A "virtual loss" is added on the path of each running playout, so
+*   that the other threads explore other branches meanwhile.
+*/
+class MCTSPlayer : public ComputerPlayer
+{
+public :
+
+    MCTSPlayer();
+
+    /// Sets the exploration constant of the UCT formula.
+    /** \note Higher values make the search wider, lower values deeper.
+    */
+    void SetExploration(float fExploration);
+    float GetExploration() const;
+
+    /// Sets the maximum number of plies of each playout.
+    void SetPlayoutLength(uint_t uiPlayoutLength);
+
+    /// Sets the probability to play a random move instead of the best one in playouts.
+    void SetRandomness(float fRandomness);
+
+    Move Search(const GameState& mGame) override;
+
+    static const uint_t MAX_NODES = 1 << 20;
+
+private :
+
+    struct Node_
+    {
+        Move   mMove;
+        /// The player who played mMove
+        uchar_t uiPlayer = 0;
+        bool   bExpanded = false;
+        uint_t uiFirstChild = 0;
+        uint_t uiChildCount = 0;
+        uint_t uiVisits = 0;
+        uint_t uiVirtualLoss = 0;
+        /// Sum of the results for uiPlayer
+        float  fWins = 0.0f;
+    };
+
+    /// What each search thread works on
+    struct SearchThread_
+    {
+        GameState mGame;
+        std::vector<uint_t> lPath;
+        std::vector<Move> lMoveList;
+        std::mt19937 mRandom;
+        uint64_t uiPlayouts = 0;
+    };
+
+    void Work_(SearchThread_& mThread);
+    void Iterate_(SearchThread_& mThread);
+    uint_t SelectChild_(const Node_& mNode) const;
+    void Expand_(uint_t uiNode, SearchThread_& mThread);
+    float Playout_(SearchThread_& mThread);
+    Move ChoosePlayoutMove_(SearchThread_& mThread);
+
+    /// Plays a move, or ends the turn for a pass (Move()).
+    static void PlayMove_(GameState& mGame, const Move& mMove);
+
+    float  fExploration_ = 0.7f;
+    uint_t uiPlayoutLength_ = 16;
+    float  fRandomness_ = 0.2f;
+
+    GameState mRoot_;
+    std::vector<Node_> lNodeList_;
+    std::mutex mTreeMutex_;
+    uint_t uiMaxDepth_ = 0;
+
+    std::vector<SearchThread_> lThreadList_;
+};
+
+#endif
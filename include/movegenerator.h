@@ -0,0 +1,103 @@
+#ifndef MOVEGENERATOR_H
+#define MOVEGENERATOR_H
+
+#include "utils.h"
+#include "bitboard.h"
+
+/// Computes the available movements of orbs using bitboards
+/** All the geometry of the cross shaped board is precomputed
+*   once in lookup tables (board mask, neighbors, rays in each
+*   of the 8 directions, home areas), so that generating the
+*   movements of an orb only involves a few mask operations
+*   per direction and per jump.
+*/
+class MoveGenerator
+{
+public :
+
+    enum Direction
+    {
+        DIR_RIGHT = 0,
+        DIR_LEFT,
+        DIR_DOWN,
+        DIR_UP,
+        DIR_DOWN_RIGHT,
+        DIR_UP_LEFT,
+        DIR_DOWN_LEFT,
+        DIR_UP_RIGHT,
+        DIR_COUNT
+    };
+
+    /// Returns the mask of all the slots that belong to the board.
+    static const BitBoard& GetBoardMask();
+
+    /// Checks if a slot belongs to the board.
+    /** \param mSlot The slot to check
+    *   \return 'false' if the slot is outside of the 10x10 area, or in a cut corner
+    */
+    static bool IsOnBoard(const Slot& mSlot);
+
+    /// Returns the mask of the home area of a given color.
+    /** \param uiHome The home type (same order as Tile::Type)
+    */
+    static const BitBoard& GetHomeMask(uint_t uiHome);
+
+    /// Returns the (up to 8) slots adjacent to a given slot.
+    static const BitBoard& GetNeighbors(uint_t uiIndex);
+
+    /// Returns all the slots of the board in a given direction, starting after uiIndex.
+    static const BitBoard& GetRay(uint_t uiIndex, uint_t uiDirection);
+
+    /// Moves all the bits of a mask by one slot in a given direction.
+    /** \note Bits that would leave the board are discarded.
+    */
+    static BitBoard Shift(const BitBoard& mBoard, uint_t uiDirection);
+
+    /// Returns the landing slots of all the single jumps starting from a slot.
+    /** \param mOccupied The mask of occupied slots
+    *   \param uiIndex   The slot to jump from
+    *   \param uiOrigin  The slot where the moving orb started (cannot be jumped over)
+    *   \note An orb can jump over another orb located at any distance N in a straight
+    *         line, provided that the N slots behind it are free.
+    */
+    static BitBoard GetJumps(const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin);
+
+    /// Returns the landing slot of a single jump in a given direction.
+    /** \param mOccupied   The mask of occupied slots
+    *   \param uiIndex     The slot to jump from
+    *   \param uiOrigin    The slot where the moving orb started (cannot be jumped over)
+    *   \param uiDirection The direction of the jump
+    *   \return npos if there is no jump in this direction
+    */
+    static uint_t GetJumpLanding(const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin, uint_t uiDirection);
+
+    /// Finds a chain of jumps leading from a slot to another.
+    /** \param mOccupied   The mask of occupied slots (including the orb itself)
+    *   \param uiFrom      The slot where the orb is
+    *   \param uiTo        The slot to reach
+    *   \param lDirections Receives the direction of each jump
+    *   \return 'false' if uiTo cannot be reached with jumps only
+    *   \note The path has the fewest possible jumps.
+    */
+    static bool GetJumpPath(const BitBoard& mOccupied, uint_t uiFrom, uint_t uiTo, std::vector<uchar_t>& lDirections);
+
+    /// Returns all the slots an orb can reach in a single turn.
+    /** \param mOccupied The mask of occupied slots (including the orb itself)
+    *   \param uiIndex   The slot where the orb is
+    *   \return The free adjacent slots, and all the slots that can be reached
+    *           with a chain of jumps (the starting slot is not included)
+    */
+    static BitBoard GetMovements(const BitBoard& mOccupied, uint_t uiIndex);
+
+    /// Returns all the slots an orb can reach in a single turn, and what they depend on.
+    /** \param mOccupied     The mask of occupied slots (including the orb itself)
+    *   \param uiIndex       The slot where the orb is
+    *   \param mDependencies Receives the slots whose occupancy was looked at
+    *   \return The same as GetMovements()
+    *   \note The movements can only change if an orb enters or leaves one of
+    *         the slots of mDependencies (or if this orb moves).
+    */
+    static BitBoard GetMovements(const BitBoard& mOccupied, uint_t uiIndex, BitBoard& mDependencies);
+};
+
+#endif
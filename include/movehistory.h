@@ -0,0 +1,82 @@
+#ifndef MOVEHISTORY_H
+#define MOVEHISTORY_H
+
+#include "utils.h"
+#include "gamestate.h"
+
+/// Append-only record of the turns of a game
+/** Turns are packed in a byte stream : the origin and destination slots
+*   take one byte each, and a chain of jumps adds one byte for the number
+*   of jumps, plus 3 bits per jump for its direction. A turn where no orb
+*   was moved is stored as Move().<br>
+*   A copy of the position is kept every SNAPSHOT_INTERVAL turns, so that
+*   the position at any ply is found by replaying at most
+*   SNAPSHOT_INTERVAL-1 turns.
+*/
+class MoveHistory
+{
+public :
+
+    /// A decoded turn
+    struct Turn
+    {
+        Move mMove;
+        /// Direction of each jump (see MoveGenerator::Direction), empty for a single step
+        std::vector<uchar_t> lJumpList;
+    };
+
+    /// Creates an empty history, starting from the initial layout.
+    MoveHistory();
+
+    /// Forgets all the turns.
+    void Clear();
+
+    /// Records a turn, played from the position reached by the previous ones.
+    /** \param mMove The turn (Move() if no orb was moved)
+    *   \return 'false' if the rules don't allow this turn (it is then not recorded)
+    */
+    bool Push(const Move& mMove);
+
+    /// Returns the number of recorded turns.
+    uint_t GetSize() const;
+
+    /// Returns the number of bytes used by the encoded turns.
+    uint_t GetDataSize() const;
+
+    /// Decodes a turn.
+    /** \param uiPly The index of the turn (0 for the first one)
+    */
+    Turn GetTurn(uint_t uiPly) const;
+
+    /// Returns all the turns, without the jumps.
+    std::vector<Move> GetMoveList() const;
+
+    /// Computes the position reached after a given number of turns.
+    /** \param uiPly The number of turns to play (clamped to GetSize())
+    *   \param mGame Receives the position
+    */
+    void GetPosition(uint_t uiPly, GameState& mGame) const;
+
+    /// Returns the position reached after the last turn.
+    const GameState& GetLastPosition() const;
+
+    static const uint_t SNAPSHOT_INTERVAL = 32;
+
+private :
+
+    struct Snapshot_
+    {
+        GameState mGame;
+        uint_t    uiOffset = 0;
+    };
+
+    uint_t Decode_(uint_t uiOffset, Move& mMove, std::vector<uchar_t>* pJumpList) const;
+    static void Play_(GameState& mGame, const Move& mMove);
+
+    std::vector<uchar_t>   lData_;
+    std::vector<Snapshot_> lSnapshotList_;
+    GameState              mLastPosition_;
+    uint_t                 uiSize_ = 0;
+};
+
+#endif
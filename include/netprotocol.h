@@ -0,0 +1,68 @@
+#ifndef NETPROTOCOL_H
+#define NETPROTOCOL_H
+
+#include "utils.h"
+#include "gamestate.h"
+
+/// A message exchanged by two networked games
+struct NetMessage
+{
+    enum Type
+    {
+        /// First message sent on a new connection
+        TYPE_HELLO = 1,
+        /// A complete turn
+        TYPE_MOVE,
+        /// The player left the game
+        TYPE_BYE
+    };
+
+    Type mType = TYPE_BYE;
+    /// TYPE_HELLO : the player controlled by the sender (0 or 1)
+    uint_t uiPlayer = 0;
+    /// TYPE_MOVE : the number of turns played before this one
+    uint_t uiPly = 0;
+    /// TYPE_MOVE : the turn (Move() if no orb was moved)
+    Move mMove;
+};
+
+/// Encodes and decodes network messages
+/** Only the turns are sent, never the whole board : each player
+*   plays them on its own GameState, and checks them against the rules.<br>
+*   Every message starts with its type (one byte), and has a fixed size :
+*   HELLO carries a magic number, the protocol version and the player of
+*   the sender (6 bytes), MOVE carries the ply number and the origin and
+*   destination slots (5 bytes), BYE carries nothing (1 byte).
+*/
+class NetProtocol
+{
+public :
+
+    /// Appends an encoded message to a buffer.
+    /** \param mMessage The message to send
+    *   \param lBuffer  The buffer to fill
+    */
+    static void Write(const NetMessage& mMessage, std::vector<uchar_t>& lBuffer);
+
+    /// Encodes a message in a fixed-size buffer.
+    /** \param mMessage The message to send
+    *   \param pBuffer  The buffer to fill (at least MAX_MESSAGE_SIZE bytes)
+    *   \return The number of bytes written
+    */
+    static uint_t Write(const NetMessage& mMessage, uchar_t* pBuffer);
+
+    /// Decodes the first message of a buffer.
+    /** \param pData    The received data
+    *   \param uiSize   The number of bytes received
+    *   \param mMessage The message to fill
+    *   \return The number of bytes used by the message, 0 if more data is
+    *           needed, or npos if the data is not a valid message
+    */
+    static uint_t Read(const uchar_t* pData, uint_t uiSize, NetMessage& mMessage);
+
+    static const uint_t VERSION = 1;
+    static const uint_t MAX_MESSAGE_SIZE = 6;
+    static const unsigned short DEFAULT_PORT = 4242;
+};
+
+#endif
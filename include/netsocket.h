@@ -0,0 +1,28 @@
+#ifndef NETSOCKET_H
+#define NETSOCKET_H
+
+#include "utils.h"
+
+/// Thin helpers over POSIX sockets, for the headless network tools
+/** The game itself uses sfml-network (see NetworkPlayer) : these are only
+*   used by orb_server and orb_loadtest, which must not depend on SFML.
+*/
+
+/// Opens a TCP socket listening to a port on all interfaces.
+/** \return The socket, or -1 on failure
+*/
+int OpenListenSocket(unsigned short uiPort);
+
+/// Connects a TCP socket to a host (blocking).
+/** \param sAddress The name or IP address of the host
+*   \param uiPort   The TCP port the host listens to
+*   \return The socket, or -1 on failure
+*/
+int ConnectSocket(const std::string& sAddress, unsigned short uiPort);
+
+/// Makes a socket non-blocking, and sends small messages without delay.
+bool SetSocketOptions(int iSocket);
+
+void CloseSocket(int iSocket);
+
+#endif
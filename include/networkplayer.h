@@ -0,0 +1,109 @@
+#ifndef NETWORKPLAYER_H
+#define NETWORKPLAYER_H
+
+#include "utils.h"
+#include "netprotocol.h"
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <deque>
+
+/// The other player of a game played over the network
+/** One game hosts (it plays player 1 and waits for a connection), the
+*   other joins it (and plays player 2). Turns are exchanged over TCP,
+*   as described in NetProtocol.<br>
+*   Nothing ever blocks the caller : sockets are non-blocking, and Update()
+*   must be called every frame to send and receive the pending data. Only
+*   the connection to a host is made in a separate thread, since SFML
+*   cannot connect without blocking.
+*/
+class NetworkPlayer
+{
+public :
+
+    enum State
+    {
+        STATE_IDLE,
+        /// Hosting, waiting for the other player to connect
+        STATE_LISTENING,
+        /// Joining, waiting for the host to accept the connection
+        STATE_CONNECTING,
+        /// Connected, waiting for the other player to introduce itself
+        STATE_HANDSHAKE,
+        /// Turns can be exchanged
+        STATE_READY,
+        /// The connection was lost or closed
+        STATE_CLOSED
+    };
+
+    NetworkPlayer();
+    ~NetworkPlayer();
+
+    NetworkPlayer(const NetworkPlayer&) = delete;
+    NetworkPlayer& operator = (const NetworkPlayer&) = delete;
+
+    /// Waits for another game to join (this game plays player 1).
+    /** \param uiPort The TCP port to listen to
+    *   \return 'false' if the port cannot be used
+    */
+    bool Host(unsigned short uiPort = NetProtocol::DEFAULT_PORT);
+
+    /// Connects to a hosting game (this game plays player 2).
+    /** \param sAddress The name or IP address of the host
+    *   \param uiPort   The TCP port the host listens to
+    */
+    void Join(const std::string& sAddress, unsigned short uiPort = NetProtocol::DEFAULT_PORT);
+
+    /// Tells the other player that we leave, and closes the connection.
+    void Close();
+
+    /// Accepts the connection, sends and receives the pending data.
+    void Update();
+
+    State GetState() const;
+
+    /// Returns the player controlled by this game (0 or 1).
+    uint_t GetLocalPlayer() const;
+
+    /// Sends a turn of the local player.
+    /** \param uiPly The number of turns played before this one
+    *   \param mMove The turn (Move() if no orb was moved)
+    */
+    void SendMove(uint_t uiPly, const Move& mMove);
+
+    /// Returns the next turn received from the other player.
+    /** \param mMessage The TYPE_MOVE message to fill
+    *   \return 'false' if no turn was received
+    *   \note The turn must still be checked against the rules.
+    */
+    bool PopMove(NetMessage& mMessage);
+
+    static const std::string CLASS_NAME;
+
+private :
+
+    /// Shared with the connecting thread, which may outlive this object
+    struct Connection_
+    {
+        sf::TcpSocket       mSocket;
+        sf::Socket::Status  mStatus = sf::Socket::NotReady;
+        std::atomic<bool>   bDone;
+    };
+
+    void OnConnected_();
+    void Receive_();
+    void Send_();
+    void Fail_(const std::string& sMessage);
+
+    State  mState_ = STATE_IDLE;
+    uint_t uiLocalPlayer_ = 0;
+
+    sf::TcpListener              mListener_;
+    std::shared_ptr<Connection_> pConnection_;
+
+    std::vector<uchar_t>   lInBuffer_;
+    std::vector<uchar_t>   lOutBuffer_;
+    std::deque<NetMessage> lMoveList_;
+};
+
+#endif
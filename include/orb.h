@@ -3,11 +3,13 @@
 
 #include "utils.h"
 #include "sprite.h"
+#include "gamestate.h"
 
 using Vector2D = Point<float>;
 using Slot = Point<int>;
 
 class Sprite;
+class SpriteBatch;
 
 class Orb
 {
@@ -15,16 +17,20 @@ public :
 
     enum Type
     {
-        BLUE = 0,
-        RED,
-        GREEN,
-        PINK
+        BLUE = GameState::BLUE,
+        RED = GameState::RED,
+        GREEN = GameState::GREEN,
+        PINK = GameState::PINK
     };
 
     Orb(const Vector2D& mPos, const Slot& mSlot, Type mType);
     ~Orb();
 
-    void Render() const;
+    /// Adds the crosses showing where this orb can go (only if the mouse is over it).
+    void RenderMovements(SpriteBatch& mBatch) const;
+
+    /// Adds this orb to a batch.
+    void Render(SpriteBatch& mBatch) const;
 
     void SetTempPosition(const Vector2D& mPos);
     void SetPosition(const Vector2D& mPos, const Slot& mSlot);
@@ -0,0 +1,61 @@
+#ifndef SAVEFILE_H
+#define SAVEFILE_H
+
+#include "utils.h"
+#include "gamestate.h"
+
+/// Everything needed to resume a game
+struct SaveData
+{
+    /// Shown to the player when choosing a slot
+    std::string sName;
+    /// Who plays as player 2 (see Application::Opponent)
+    uint_t uiOpponent = 0;
+    /// The position, including the orb moved during the current turn
+    GameState mGame;
+    /// The turns played so far
+    std::vector<Move> lHistory;
+};
+
+/// Reads and writes saved games
+/** Games are saved in a compact binary format : a header (magic
+*   number, version, size and CRC-32 of the content), followed by
+*   the content. The position takes one byte per orb, and each turn
+*   of the history takes two bytes.<br>
+*   Files are first written under another name then renamed, so that
+*   a crash while saving never destroys the previous save.
+*/
+class SaveFile
+{
+public :
+
+    /// Writes a saved game.
+    /** \param sFile The file to write
+    *   \param mData The game to save
+    *   \return 'false' if the file could not be written
+    */
+    static bool Write(const std::string& sFile, const SaveData& mData);
+
+    /// Reads a saved game.
+    /** \param sFile The file to read
+    *   \param mData The game to fill
+    *   \return 'false' if the file is missing, corrupted or from an
+    *           unknown version (mData is then left untouched)
+    */
+    static bool Read(const std::string& sFile, SaveData& mData);
+
+    /// Reads the name of a saved game, without logging errors.
+    /** \param sFile The file to read
+    *   \param sName The name to fill
+    *   \return 'false' if the file is missing, corrupted or from an
+    *           unknown version
+    *   \note Only the header, the CRC and the name are checked : use
+    *         Read() to load the game and to report what is wrong.
+    */
+    static bool ReadName(const std::string& sFile, std::string& sName);
+
+    static const uint32_t VERSION = 1;
+    static const std::string CLASS_NAME;
+};
+
+#endif
@@ -9,6 +9,8 @@
 
 using Vector2D = Point<float>;
 
+class SpriteBatch;
+
 struct AxisAlignedBox2D
 {
     AxisAlignedBox2D()
@@ -87,6 +89,13 @@ public :
     */
     void Render(float fX, float fY) const;
 
+    /// Adds this Sprite to a batch, to be rendered later.
+    /** \param mBatch The batch to add this Sprite to
+    *   \param fX     The horizontal position
+    *   \param fY     The vertical position
+    */
+    void Render(SpriteBatch& mBatch, float fX, float fY) const;
+
     /// Deforms this Sprite and render it on the current render target.
     /** \param fX      The horizontal position
     *   \param fY      The vertical position
@@ -0,0 +1,60 @@
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include "utils.h"
+
+#include <SFML/Graphics.hpp>
+
+class Sprite;
+
+/// Draws many sprites with as few draw calls as possible
+/** Sprites are added as textured quads in a single vertex array,
+*   which is then drawn in one call per texture switch : adding all
+*   the sprites that use the same texture in a row (or using a texture
+*   atlas) gives a single draw call.<br>
+*   The batch keeps its content until it is cleared, so static
+*   elements only need to be added once.
+*/
+class SpriteBatch
+{
+public :
+
+    SpriteBatch();
+
+    /// Removes all the sprites from this batch.
+    void Clear();
+
+    /// Adds a sprite to this batch.
+    /** \param mSprite The sprite to add
+    *   \param fX      The horizontal position
+    *   \param fY      The vertical position
+    *   \note Same as Sprite::Render(), but delayed until Render() is called.
+    */
+    void Add(const Sprite& mSprite, float fX, float fY);
+
+    /// Adds a textured quad to this batch.
+    /** \param pTexture The texture to use
+    *   \param lVertices The four corners of the quad
+    */
+    void AddQuad(const sf::Texture* pTexture, const sf::Vertex* lVertices);
+
+    /// Checks if this batch is empty.
+    bool IsEmpty() const;
+
+    /// Draws all the sprites of this batch on the screen.
+    void Render() const;
+
+private :
+
+    struct Segment_
+    {
+        const sf::Texture* pTexture;
+        uint_t             uiFirst;
+        uint_t             uiCount;
+    };
+
+    std::vector<sf::Vertex> lVertexList_;
+    std::vector<Segment_>   lSegmentList_;
+};
+
+#endif
@@ -264,6 +264,9 @@ public :
     /// Renders this Text at the given position.
     /** \param fX The horizontal position of the top left corner
     *   \param fY The vertical position of the top left corner
+    *   \note All the letters are drawn in a single call. They are
+    *         only rebuilt when the text, its color or its layout
+    *         changes, not when it moves.
     *   \note Must be called between SpriteManager::Begin() and
     *         SpriteManager::End().
     */
@@ -283,6 +286,12 @@ private :
     void UpdateLines_();
     void UpdateCache_();
 
+    /// Returns the kerning between two displayed characters (none next to a space).
+    /** \note Used both to measure the lines and to place the glyphs, so
+    *         that they always agree.
+    */
+    float GetDisplayKerning_(char cChar1, char cChar2) const;
+
     std::string       sFileName_;
     bool              bReady_ = false;
     float             fSize_ = 0.0;
@@ -293,7 +302,6 @@ private :
     Color             mColor_;
     bool              bForceColor_ = false;
     float             fW_ = 0.0, fH_ = 0.0;
-    float             fX_ = 0.0, fY_ = 0.0;
     float             fBoxW_ = 0.0, fBoxH_ = 0.0;
     std::string       sText_;
     Alignment         mAlign_ = ALIGN_LEFT;
@@ -306,7 +314,7 @@ private :
     std::vector<Letter> lLetterCache_;
 
     bool                    bUpdateQuads_ = false;
-    std::vector<sf::Sprite> lQuadList_;
+    sf::VertexArray         mQuads_;
 
     Font* pFont_ = nullptr;
 };
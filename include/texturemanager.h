@@ -6,13 +6,50 @@
 
 #include <SFML/Graphics.hpp>
 
+/// A rectangle inside a texture
+struct TextureRegion
+{
+    sf::Texture* pTexture = nullptr;
+    sf::IntRect  mRect;
+};
+
+/// Loads and owns all the textures
+/** Images can either be loaded in their own texture, or packed
+*   together in a few large "atlas" textures. Sprites that share
+*   an atlas can be drawn in a single call (see SpriteBatch).
+*/
 class TextureManager : public Manager<TextureManager>
 {
 friend class Manager<TextureManager>;
 public :
 
+    /// Loads an image in its own texture.
+    /** \param sFile The image file
+    */
     sf::Texture* LoadTexture(const std::string& sFile);
 
+    /// Packs several images into as few textures as possible.
+    /** \param lFileList The image files
+    *   \note Images are placed on rows, from the tallest to the
+    *         smallest, and a new atlas is started when one is full.<br>
+    *         This should be called once at startup, before any Sprite
+    *         is created.
+    */
+    void PackAtlas(const std::vector<std::string>& lFileList);
+
+    /// Returns the region of the texture that contains an image.
+    /** \param sFile The image file
+    *   \return The region in the atlas, if the image was packed with
+    *           PackAtlas(), else the whole texture of LoadTexture()
+    */
+    const TextureRegion& LoadRegion(const std::string& sFile);
+
+    /// Returns the number of atlas textures created by PackAtlas().
+    uint_t GetAtlasCount() const;
+
+    static const uint_t ATLAS_SIZE = 1024;
+    static const uint_t ATLAS_PADDING = 2;
+
     static const std::string CLASS_NAME;
 
 protected:
@@ -23,6 +60,8 @@ protected:
 private:
 
     std::map< std::string, std::unique_ptr<sf::Texture> > lTextureList_;
+    std::vector< std::unique_ptr<sf::Texture> >           lAtlasList_;
+    std::map< std::string, TextureRegion >                lRegionList_;
 
 };
 
@@ -3,6 +3,7 @@
 
 #include "utils.h"
 #include "orb.h"
+#include "bitboard.h"
 
 using Vector2D = Point<float>;
 using Slot = Point<int>;
@@ -27,25 +28,27 @@ public :
     const Slot& GetSlot() const;
 
     bool IsOnSlot(const Slot& mSlot) const;
-    void AddNeighbor(Tile* pTile);
-    Tile* GetNeighbor(const Slot& mDirection) const;
     void SetOrb(Orb* pOrb);
     Orb* GetOrb() const;
     bool IsOccupied();
-    void ComputeAvailableMovements();
+    void ComputeAvailableMovements(const BitBoard& mOccupied);
 
     const std::vector<Slot>& GetAvailableMovements() const;
 
-private :
+    /// Returns the slots the last computed movements depend on.
+    /** \note The movements only need to be computed again if an orb
+    *         enters or leaves one of these slots, or this tile.
+    */
+    const BitBoard& GetDependencies() const;
 
-    std::vector< Tile* > GetFirstStepNeighbors_(Tile* pStart, const std::vector< Tile* >& lVisitedTiles) const;
+private :
 
     Slot mSlot_;
     Type mType_;
     Orb* pOrb_ = nullptr;
 
     std::vector<Slot> lAvailableMovements_;
-    std::vector< Tile* > lNeighborList_;
+    BitBoard          mDependencies_;
 };
 
 #endif
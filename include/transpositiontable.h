@@ -0,0 +1,93 @@
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+
+#include "utils.h"
+#include "gamestate.h"
+
+#include <atomic>
+
+/// What a search learned about a position
+struct TranspositionEntry
+{
+    enum Bound
+    {
+        BOUND_NONE = 0,
+        BOUND_EXACT,
+        BOUND_LOWER,
+        BOUND_UPPER
+    };
+
+    /// Best move found (or the move that caused the cutoff)
+    Move   mMove;
+    /// Score, from the point of view of the player to move
+    int    iScore = 0;
+    /// Remaining depth of the search that produced this entry
+    uint_t uiDepth = 0;
+    /// Tells if iScore is exact, or only a lower/upper bound
+    Bound  mBound = BOUND_NONE;
+};
+
+/// Fixed size cache of search results, indexed by position hash
+/** Each entry is stored in two 64 bit words : the packed data, and
+*   the hash XORed with the data. Reads and writes are lock-free :
+*   an entry torn by a concurrent write fails the hash check, and is
+*   then simply treated as a miss.<br>
+*   When two positions fall in the same bucket, deeper and more
+*   recent results are kept.
+*/
+class TranspositionTable
+{
+public :
+
+    /// Creates a table.
+    /** \param uiSizeMB The memory to use (in megabytes)
+    */
+    explicit TranspositionTable(uint_t uiSizeMB = 16);
+
+    /// Changes the memory used by the table.
+    /** \param uiSizeMB The memory to use (in megabytes)
+    *   \note The table is cleared. The number of entries is rounded
+    *         down to a power of two.
+    */
+    void Resize(uint_t uiSizeMB);
+
+    /// Removes all the entries.
+    void Clear();
+
+    /// Marks the entries of the previous searches as replaceable.
+    void NewSearch();
+
+    /// Looks for a position in the table.
+    /** \param uiHash The hash of the position
+    *   \param mEntry Filled with the stored entry if found
+    *   \return 'true' if the position was found
+    */
+    bool Probe(uint64_t uiHash, TranspositionEntry& mEntry) const;
+
+    /// Stores the result of a search.
+    /** \param uiHash The hash of the position
+    *   \param mEntry The result to store
+    */
+    void Store(uint64_t uiHash, const TranspositionEntry& mEntry);
+
+    /// Returns the number of entries the table can hold.
+    uint_t GetSize() const;
+
+private :
+
+    struct Bucket_
+    {
+        std::atomic<uint64_t> uiKey;
+        std::atomic<uint64_t> uiData;
+    };
+
+    static uint64_t Pack_(const TranspositionEntry& mEntry, uint_t uiGeneration);
+    static TranspositionEntry Unpack_(uint64_t uiData);
+    static uint_t GetGeneration_(uint64_t uiData);
+
+    std::unique_ptr<Bucket_[]> lBucketList_;
+    uint64_t uiMask_ = 0;
+    uint_t   uiGeneration_ = 0;
+};
+
+#endif
@@ -36,6 +36,12 @@ std::string ToString(const T& mObject) {
 }
 
 bool FileExists(const std::string& sFilename);
+/// Returns the last modification time of a file (0 if it doesn't exist).
+long long GetFileTime(const std::string& sFilename);
+/// Creates a directory (does nothing if it already exists).
+bool MakeDirectory(const std::string& sDirectory);
+/// Renames a file, replacing the destination if it exists.
+bool ReplaceFile(const std::string& sSource, const std::string& sDestination);
 uint_t HexToUInt(const std::string& sStr);
 uint_t CountOccurrences(const std::string& sStr, const std::string& sPattern);
 std::string Replace(std::string sStr, const std::string& sPattern, const std::string& sReplacement);
@@ -0,0 +1,26 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "utils.h"
+#include "bitboard.h"
+
+/// Random keys used to hash positions
+/** The hash of a position is the XOR of the key of each orb
+*   (one key per color and per slot), and of the player key if
+*   it is player 2's turn. It can thus be updated incrementally
+*   when an orb moves or when the turn ends.<br>
+*   Keys are generated from a fixed seed : hashes are the same
+*   from one run to the other.
+*/
+class Zobrist
+{
+public :
+
+    /// Returns the key of an orb of a given color on a given slot.
+    static uint64_t GetOrbKey(uint_t uiColor, uint_t uiIndex);
+
+    /// Returns the key XORed in when it is player 2's turn.
+    static uint64_t GetPlayerKey();
+};
+
+#endif
@@ -0,0 +1,288 @@
+#include "aiplayer.h"
+#include "movegenerator.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    /// Distance of every slot to the home of each color, built on first use.
+    struct DistanceTable
+    {
+        DistanceTable()
+        {
+            for (uint_t c = 0; c < 4; ++c)
+            {
+                const BitBoard& mHome = MoveGenerator::GetHomeMask(c);
+                for (uint_t i = 0; i < BitBoard::SIZE; ++i)
+                {
+                    // Orbs can move diagonally : the number of steps to
+                    // reach the closest home slot is the Chebyshev distance
+                    Slot mSlot = BitBoard::GetSlot(i);
+                    int iMinDistance = std::numeric_limits<int>::max();
+
+                    BitBoard mTargets = mHome;
+                    while (!mTargets.IsEmpty())
+                    {
+                        Slot mHomeSlot = BitBoard::GetSlot(mTargets.PopFirst());
+                        int iDistance = std::max(std::abs(mHomeSlot.X() - mSlot.X()), std::abs(mHomeSlot.Y() - mSlot.Y()));
+                        iMinDistance = std::min(iMinDistance, iDistance);
+                    }
+
+                    lDistanceList[c][i] = iMinDistance;
+                }
+            }
+        }
+
+        std::array<std::array<int, BitBoard::SIZE>, 4> lDistanceList;
+    };
+
+    const DistanceTable& GetDistanceTable()
+    {
+        static const DistanceTable mTable;
+        return mTable;
+    }
+
+    int GetPlayerDistance(const GameState& mGame, uint_t uiPlayer)
+    {
+        const DistanceTable& mTable = GetDistanceTable();
+
+        int iDistance = 0;
+        for (uint_t c = 2*uiPlayer; c < 2*uiPlayer + 2; ++c)
+        {
+            // Player 1 controls BLUE and RED, player 2 GREEN and PINK
+            BitBoard mOrbs = mGame.GetColorMask((GameState::Color)c);
+            while (!mOrbs.IsEmpty())
+                iDistance += mTable.lDistanceList[c][mOrbs.PopFirst()];
+        }
+
+        return iDistance;
+    }
+
+    /// Win scores are stored relative to the position, not to the root.
+    int ToTableScore(int iScore, uint_t uiPly)
+    {
+        if (iScore > AIPlayer::WIN_SCORE/2)
+            return iScore + int(uiPly);
+        else if (iScore < -AIPlayer::WIN_SCORE/2)
+            return iScore - int(uiPly);
+        else
+            return iScore;
+    }
+
+    int FromTableScore(int iScore, uint_t uiPly)
+    {
+        if (iScore > AIPlayer::WIN_SCORE/2)
+            return iScore - int(uiPly);
+        else if (iScore < -AIPlayer::WIN_SCORE/2)
+            return iScore + int(uiPly);
+        else
+            return iScore;
+    }
+}
+
+void AIPlayer::SetMaxDepth(uint_t uiMaxDepth)
+{
+    uiMaxDepth_ = std::max(uiMaxDepth, uint_t(1));
+}
+
+void AIPlayer::SetHashSize(uint_t uiSizeMB)
+{
+    mTable_.Resize(uiSizeMB);
+}
+
+int AIPlayer::GetHomeDistance(uint_t uiColor, uint_t uiIndex)
+{
+    return GetDistanceTable().lDistanceList[uiColor][uiIndex];
+}
+
+int AIPlayer::Evaluate(const GameState& mGame)
+{
+    uint_t uiPlayer = mGame.GetPlayer();
+    return GetPlayerDistance(mGame, 1 - uiPlayer) - GetPlayerDistance(mGame, uiPlayer);
+}
+
+Move AIPlayer::Search(const GameState& mGame)
+{
+    StartSearch_();
+    mTable_.NewSearch();
+
+    // Each thread works on its own copy of the game
+    lThreadList_.resize(uiThreadCount_);
+    for (auto& mThread : lThreadList_)
+    {
+        mThread.mGame = mGame;
+        mThread.lMoveStack.resize(uiMaxDepth_ + 1);
+        mThread.uiNodes = 0;
+    }
+
+    // Helper threads search the same position, and only share their
+    // results through the transposition table. Starting them at different
+    // depths makes them explore different parts of the tree.
+    std::vector<std::thread> lHelperList;
+    for (uint_t i = 1; i < uiThreadCount_; ++i)
+    {
+        lHelperList.push_back(std::thread([this, i]() {
+            Move mMove;
+            int iScore;
+            IterativeDeepening_(lThreadList_[i], 1 + i % 2, mMove, iScore);
+        }));
+    }
+
+    Move mBestMove;
+    mLastInfo_.uiDepth = IterativeDeepening_(lThreadList_[0], 1, mBestMove, mLastInfo_.iScore);
+
+    bStop_ = true;
+    for (auto& mHelper : lHelperList)
+        mHelper.join();
+
+    for (auto& mThread : lThreadList_)
+        mLastInfo_.uiNodes += mThread.uiNodes;
+
+    EndSearch_();
+
+    return mBestMove;
+}
+
+uint_t AIPlayer::IterativeDeepening_(SearchThread_& mThread, uint_t uiStartDepth, Move& mBestMove, int& iBestScore)
+{
+    GameState& mRoot = mThread.mGame;
+    uint_t uiCompletedDepth = 0;
+
+    std::vector<Move>& lRootMoves = mThread.lMoveStack[0];
+    mRoot.GenerateMoves(lRootMoves);
+    if (lRootMoves.empty())
+        return 0;
+
+    SortMoves_(mRoot, lRootMoves, Move());
+    mBestMove = lRootMoves.front();
+    iBestScore = 0;
+
+    for (uint_t uiDepth = uiStartDepth; uiDepth <= uiMaxDepth_; ++uiDepth)
+    {
+        // Search the best move of the previous iteration first
+        SortMoves_(mRoot, lRootMoves, mBestMove);
+
+        int iAlpha = -WIN_SCORE - 1;
+        Move mIterationBest = lRootMoves.front();
+        for (auto& mMove : lRootMoves)
+        {
+            mRoot.PlayMove(mMove);
+            int iScore = -AlphaBeta_(mThread, uiDepth - 1, -WIN_SCORE - 1, -iAlpha, 1);
+            mRoot.UndoMove(mMove);
+
+            if (bStop_)
+                break;
+
+            if (iScore > iAlpha)
+            {
+                iAlpha = iScore;
+                mIterationBest = mMove;
+            }
+        }
+
+        if (bStop_)
+            break;
+
+        mBestMove = mIterationBest;
+        iBestScore = iAlpha;
+        uiCompletedDepth = uiDepth;
+
+        // No need to look further if the outcome is known
+        if (std::abs(iAlpha) >= WIN_SCORE - int(uiMaxDepth_))
+            break;
+    }
+
+    return uiCompletedDepth;
+}
+
+int AIPlayer::AlphaBeta_(SearchThread_& mThread, uint_t uiDepth, int iAlpha, int iBeta, uint_t uiPly)
+{
+    ++mThread.uiNodes;
+    if ((mThread.uiNodes & 255) == 0 && IsTimeOut_())
+        bStop_ = true;
+
+    if (bStop_)
+        return 0;
+
+    GameState& mGame = mThread.mGame;
+
+    // The previous player just brought all his orbs home
+    if (mGame.IsOver())
+        return -WIN_SCORE + int(uiPly);
+
+    if (uiDepth == 0)
+        return Evaluate(mGame);
+
+    TranspositionEntry mEntry;
+    if (mTable_.Probe(mGame.GetHash(), mEntry) && mEntry.uiDepth >= uiDepth)
+    {
+        int iScore = FromTableScore(mEntry.iScore, uiPly);
+        if (mEntry.mBound == TranspositionEntry::BOUND_EXACT ||
+            (mEntry.mBound == TranspositionEntry::BOUND_LOWER && iScore >= iBeta) ||
+            (mEntry.mBound == TranspositionEntry::BOUND_UPPER && iScore <= iAlpha))
+            return iScore;
+    }
+
+    std::vector<Move>& lMoveList = mThread.lMoveStack[uiPly];
+    mGame.GenerateMoves(lMoveList);
+
+    // Search first the best move found the last time we were here (if any)
+    SortMoves_(mGame, lMoveList, mEntry.mMove);
+
+    int iAlphaStart = iAlpha;
+    Move mBestMove;
+    for (auto& mMove : lMoveList)
+    {
+        mGame.PlayMove(mMove);
+        int iScore = -AlphaBeta_(mThread, uiDepth - 1, -iBeta, -iAlpha, uiPly + 1);
+        mGame.UndoMove(mMove);
+
+        if (bStop_)
+            return 0;
+
+        if (iScore > iAlpha)
+        {
+            iAlpha = iScore;
+            mBestMove = mMove;
+            if (iAlpha >= iBeta)
+                break;
+        }
+    }
+
+    mEntry.uiDepth = uiDepth;
+    mEntry.iScore = ToTableScore(iAlpha, uiPly);
+    if (iAlpha >= iBeta)
+        mEntry.mBound = TranspositionEntry::BOUND_LOWER;
+    else if (iAlpha > iAlphaStart)
+        mEntry.mBound = TranspositionEntry::BOUND_EXACT;
+    else
+        mEntry.mBound = TranspositionEntry::BOUND_UPPER;
+
+    // On a fail low, keep the previous best move to order the next search
+    if (mBestMove != Move())
+        mEntry.mMove = mBestMove;
+
+    mTable_.Store(mGame.GetHash(), mEntry);
+
+    return iAlpha;
+}
+
+void AIPlayer::SortMoves_(const GameState& mGame, std::vector<Move>& lMoveList, const Move& mFirst) const
+{
+    const DistanceTable& mTable = GetDistanceTable();
+
+    // Try first the moves that bring the orb closest to its home
+    auto mGain = [&](const Move& mMove) {
+        uint_t uiColor = mGame.GetOrbColor(mGame.GetOrbAt(uint_t(mMove.uiFrom)));
+        return mTable.lDistanceList[uiColor][mMove.uiFrom] - mTable.lDistanceList[uiColor][mMove.uiTo];
+    };
+
+    std::stable_sort(lMoveList.begin(), lMoveList.end(), [&](const Move& mMove1, const Move& mMove2) {
+        return mGain(mMove1) > mGain(mMove2);
+    });
+
+    auto iter = std::find(lMoveList.begin(), lMoveList.end(), mFirst);
+    if (iter != lMoveList.end())
+        std::rotate(lMoveList.begin(), iter, iter + 1);
+}
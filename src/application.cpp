@@ -1,12 +1,19 @@
 #include "application.h"
 #include "inputmanager.h"
 #include "texturemanager.h"
+#include "fontmanager.h"
 #include "sprite.h"
 #include "menu.h"
 #include "board.h"
 #include "button.h"
+#include "savefile.h"
+#include "networkplayer.h"
+#include "log.h"
+
+#include <ctime>
 
 const std::string Application::CLASS_NAME = "Application";
+const std::string Application::SAVE_DIRECTORY = "saves";
 
 void ReturnGame(Application& mApp)
 {
@@ -20,9 +27,37 @@ void SaveGame(Application& mApp)
 
 void NewGame(Application& mApp)
 {
+    mApp.SetOpponent(Application::OPPONENT_HUMAN);
+    mApp.SetState(Application::STATE_NEWGAME);
+}
+
+void NewGameComputer(Application& mApp)
+{
+    mApp.SetOpponent(Application::OPPONENT_ALPHABETA);
     mApp.SetState(Application::STATE_NEWGAME);
 }
 
+void NewGameMCTS(Application& mApp)
+{
+    mApp.SetOpponent(Application::OPPONENT_MCTS);
+    mApp.SetState(Application::STATE_NEWGAME);
+}
+
+void NetworkGame(Application& mApp)
+{
+    mApp.SetState(Application::STATE_NETWORK);
+}
+
+void HostGame(Application& mApp)
+{
+    mApp.StartNetworkGame(true);
+}
+
+void JoinGame(Application& mApp)
+{
+    mApp.StartNetworkGame(false);
+}
+
 void LoadGame(Application& mApp)
 {
     mApp.SetState(Application::STATE_LOAD);
@@ -58,11 +93,25 @@ Application::Application() : uiScreenWidth_(1024u), uiScreenHeight_(768u), sLang
     std::string sHelp;
     std::string sMainMenu;
     std::string sNewGame;
+    std::string sNewGameComputer;
+    std::string sNewGameMCTS;
+    std::string sNetworkGame;
+    std::string sHostGame;
+    std::string sJoinGame;
     std::string sLoadGame;
     std::string sQuit;
     if (sLanguage_ == "fr") {
         sMainMenu = "Menu principal";
         sNewGame = "Nouvelle partie";
+        sNewGameComputer = "Contre l'ordinateur";
+        sNewGameMCTS = "Contre l'ordinateur (MCTS)";
+        sNetworkGame = "Partie en reseau";
+        sHostGame = "Heberger";
+        sJoinGame = "Rejoindre";
+        sAddressLabel_ = "Adresse : ";
+        sWaitingPlayer_ = "En attente d'un joueur (port [PORT])...";
+        sConnecting_ = "Connexion...";
+        sConnectionFailed_ = "Connexion impossible.";
         sLoadGame = "Charger partie";
         sQuit = "Quitter";
         sHelp = "Appuyez sur [Echap] pour revenir au menu.";
@@ -71,6 +120,15 @@ Application::Application() : uiScreenWidth_(1024u), uiScreenHeight_(768u), sLang
     {
         sMainMenu = "Main menu";
         sNewGame = "New game";
+        sNewGameComputer = "Versus computer";
+        sNewGameMCTS = "Versus computer (MCTS)";
+        sNetworkGame = "Network game";
+        sHostGame = "Host";
+        sJoinGame = "Join";
+        sAddressLabel_ = "Address : ";
+        sWaitingPlayer_ = "Waiting for a player (port [PORT])...";
+        sConnecting_ = "Connecting...";
+        sConnectionFailed_ = "Cannot connect.";
         sLoadGame = "Load game";
         sQuit = "Exit";
         sHelp = "Press [Escape] to go back to the main menu.";
@@ -80,6 +138,16 @@ Application::Application() : uiScreenWidth_(1024u), uiScreenHeight_(768u), sLang
     mWindow_.setMouseCursorVisible(false);
     mWindow_.setFramerateLimit(60);
     InputManager::GetSingleton()->Initialize(float(uiScreenWidth_), float(uiScreenHeight_), &mWindow_);
+    // Follow every mouse event, so that orbs are picked and dropped where
+    // the button was used, even at low frame rates
+    InputManager::GetSingleton()->SetHighRateMouse(true);
+
+    // Pack all the sprites together, so that batches only need one texture
+    TextureManager::GetSingleton()->PackAtlas({
+        "cursor.png", "cross.png", "grid.png", "grid_home.png",
+        "orb_blue.png", "orb_red.png", "orb_green.png", "orb_pink.png",
+        "menu_button.png", "menu_button_highlight.png", "menu_button_down.png", "menu_button_disabled.png"
+    });
 
     pCursor_ = std::unique_ptr<Sprite>(new Sprite("cursor.png"));
 
@@ -91,22 +159,35 @@ Application::Application() : uiScreenWidth_(1024u), uiScreenHeight_(768u), sLang
     pHelpText_->SetText(sHelp);
     pHelpText_->SetAlignment(Text::ALIGN_CENTER);
 
+    pStatsText_ = std::unique_ptr<Text>(new Text("ravie.ttf", 12));
+
     pMainMenu_ = std::unique_ptr<Menu>(new Menu(sMainMenu, *this));
     pMainMenu_->AddItem(0, sNewGame, &NewGame);
-    pMainMenu_->AddItem(3, sLoadGame, &LoadGame);
-    pMainMenu_->AddItem(4, sQuit, &Quit);
+    pMainMenu_->AddItem(1, sNewGameComputer, &NewGameComputer);
+    pMainMenu_->AddItem(2, sNewGameMCTS, &NewGameMCTS);
+    pMainMenu_->AddItem(3, sNetworkGame, &NetworkGame);
+    pMainMenu_->AddItem(6, sLoadGame, &LoadGame);
+    pMainMenu_->AddItem(7, sQuit, &Quit);
 
-    // TODO
-    /*lSaveSlotList_[i] = std::unique_ptr<Button>(new Button(
-        Vector2D(), "save_button", "Slot "+i+".", &SaveSlot<1>, *this
-    ));
+    static const std::array<OnClickFunc, SLOT_COUNT> lSlotFuncList = {{
+        &SaveSlot<0>, &SaveSlot<1>, &SaveSlot<2>, &SaveSlot<3>, &SaveSlot<4>
+    }};
 
-    for (uint_t i; i < 5; ++i)
+    for (uint_t i = 0; i < SLOT_COUNT; ++i)
     {
-        Button* pButton =
+        lSaveSlotList_[i] = std::unique_ptr<Button>(new Button(
+            Vector2D(512, 244 + 70*i), "menu_button", "", lSlotFuncList[i], *this
+        ));
+    }
+
+    pAddressText_ = std::unique_ptr<Text>(new Text("ravie.ttf", 24));
+    pAddressText_->SetAlignment(Text::ALIGN_CENTER);
 
-        pButton->GetText()->SetAlignment(ALIGN_LEFT);
-    }*/
+    pNetworkText_ = std::unique_ptr<Text>(new Text("ravie.ttf", 14));
+    pNetworkText_->SetAlignment(Text::ALIGN_CENTER);
+
+    pHostButton_ = std::unique_ptr<Button>(new Button(Vector2D(512, 384), "menu_button", sHostGame, &HostGame, *this));
+    pJoinButton_ = std::unique_ptr<Button>(new Button(Vector2D(512, 454), "menu_button", sJoinGame, &JoinGame, *this));
 
     mState_ = STATE_MENU;
 
@@ -115,6 +196,7 @@ Application::Application() : uiScreenWidth_(1024u), uiScreenHeight_(768u), sLang
 
 Application::~Application()
 {
+    FontManager::Delete();
     TextureManager::Delete();
     InputManager::Delete();
 }
@@ -122,6 +204,19 @@ Application::~Application()
 void Application::SetState(State mState)
 {
     mState_ = mState;
+
+    if (mState_ == STATE_SAVE || mState_ == STATE_LOAD)
+        UpdateSlots_();
+
+    if (mState_ == STATE_NETWORK)
+        pNetworkText_->SetText("");
+    else
+        pNetwork_ = nullptr;
+}
+
+void Application::SetOpponent(Opponent mOpponent)
+{
+    mOpponent_ = mOpponent;
 }
 
 std::string Application::GetLanguage() const
@@ -153,15 +248,27 @@ void Application::Loop_()
 
             if (mEvent.type == sf::Event::MouseWheelMoved)
                 pInputMgr->NotifyMouseWheelMoved(mEvent.mouseWheel.delta);
+
+            if (mEvent.type == sf::Event::MouseMoved)
+                pInputMgr->NotifyMouseMoved(mEvent.mouseMove.x, mEvent.mouseMove.y);
+
+            if ((mEvent.type == sf::Event::MouseButtonPressed || mEvent.type == sf::Event::MouseButtonReleased) &&
+                mEvent.mouseButton.button <= sf::Mouse::Middle)
+                pInputMgr->NotifyMouseButton((MouseButton)mEvent.mouseButton.button, mEvent.mouseButton.x, mEvent.mouseButton.y);
         }
 
         pInputMgr->Update(fDelta);
 
+        if (pInputMgr->KeyIsPressed(KEY_F3))
+            bShowStats_ = !bShowStats_;
+
         mWindow_.clear();
+        uiDrawCallCount_ = 0;
 
         switch (mState_)
         {
             case STATE_SAVE :
+            case STATE_LOAD :
             {
                 pOrbTitle_->Render(512, 90);
 
@@ -170,14 +277,21 @@ void Application::Loop_()
                 sf::RectangleShape mRect(sf::Vector2f(uiScreenWidth_, uiScreenHeight_));
                 mRect.setPosition(sf::Vector2f(0.0, 0.0));
                 mRect.setFillColor(sf::Color(0, 0, 0, 180));
-                mWindow_.draw(mRect);
+                Draw(mRect);
+
+                Vector2D mMouse(pInputMgr->GetMousePosX(), pInputMgr->GetMousePosY());
+                for (auto& pButton : lSaveSlotList_)
+                {
+                    pButton->Update(fDelta, mMouse, pInputMgr->MouseIsDown(MOUSE_LEFT), pInputMgr->MouseIsReleased(MOUSE_LEFT));
+                    pButton->Render();
+                }
 
                 if (pInputMgr->KeyIsPressed(KEY_ESC))
                     SetState(STATE_MENU);
 
                 break;
             }
-            case STATE_LOAD :
+            case STATE_NETWORK :
             {
                 pOrbTitle_->Render(512, 90);
 
@@ -186,7 +300,9 @@ void Application::Loop_()
                 sf::RectangleShape mRect(sf::Vector2f(uiScreenWidth_, uiScreenHeight_));
                 mRect.setPosition(sf::Vector2f(0.0, 0.0));
                 mRect.setFillColor(sf::Color(0, 0, 0, 180));
-                mWindow_.draw(mRect);
+                Draw(mRect);
+
+                UpdateNetwork_(fDelta);
 
                 if (pInputMgr->KeyIsPressed(KEY_ESC))
                     SetState(STATE_MENU);
@@ -207,26 +323,8 @@ void Application::Loop_()
             }
             case STATE_NEWGAME :
             {
-                pBoard_ = std::unique_ptr<Board>(new Board(Vector2D(
-                    (float(uiScreenWidth_) - 576)/2.0f + 130.0f,
-                    (float(uiScreenHeight_) - 576)/2.0f
-                ), *this));
-
-                std::string sContinue;
-                std::string sSaveGame;
-                if (sLanguage_ == "fr")
-                {
-                    sContinue = "Continuer";
-                    sSaveGame = "Sauver partie";
-                }
-                else if (sLanguage_ == "en")
-                {
-                    sContinue = "Continue";
-                    sSaveGame = "Save game";
-                }
-
-                pMainMenu_->AddItem(1, sContinue, &ReturnGame);
-                pMainMenu_->AddItem(2, sSaveGame, &SaveGame);
+                CreateBoard_();
+                pBoard_->SetOpponent(mOpponent_);
 
                 pBoard_->Render();
 
@@ -259,9 +357,17 @@ void Application::Loop_()
             }
         }
 
+        if (bShowStats_)
+        {
+            // Shows the draw calls of the previous frame (this one is not complete yet)
+            pStatsText_->SetText("Draw calls : "+ToString(uiLastDrawCallCount_));
+            pStatsText_->Render(10, 740);
+        }
+
         pCursor_->RenderEx(pInputMgr->GetMousePosX(), pInputMgr->GetMousePosY(), 0.0f, 0.5f, 0.5f);
 
         mWindow_.display();
+        uiLastDrawCallCount_ = uiDrawCallCount_;
 
         fDelta = mClock.getElapsedTime().asSeconds();
         mClock.restart();
@@ -273,6 +379,23 @@ sf::RenderWindow* Application::GetRenderWindow()
     return &mWindow_;
 }
 
+void Application::Draw(const sf::Drawable& mDrawable, const sf::RenderStates& mStates)
+{
+    mWindow_.draw(mDrawable, mStates);
+    ++uiDrawCallCount_;
+}
+
+void Application::Draw(const sf::Vertex* pVertices, std::size_t uiCount, sf::PrimitiveType mType, const sf::RenderStates& mStates)
+{
+    mWindow_.draw(pVertices, uiCount, mType, mStates);
+    ++uiDrawCallCount_;
+}
+
+uint_t Application::GetDrawCallCount() const
+{
+    return uiLastDrawCallCount_;
+}
+
 Application* Application::GetMainApp()
 {
     return MAIN_APP;
@@ -293,12 +416,178 @@ Board* Application::GetBoard()
     return pBoard_.get();
 }
 
+void Application::CreateBoard_()
+{
+    pBoard_ = std::unique_ptr<Board>(new Board(Vector2D(
+        (float(uiScreenWidth_) - 576)/2.0f + 130.0f,
+        (float(uiScreenHeight_) - 576)/2.0f
+    ), *this));
+
+    std::string sContinue;
+    std::string sSaveGame;
+    if (sLanguage_ == "fr")
+    {
+        sContinue = "Continuer";
+        sSaveGame = "Sauver partie";
+    }
+    else if (sLanguage_ == "en")
+    {
+        sContinue = "Continue";
+        sSaveGame = "Save game";
+    }
+
+    pMainMenu_->AddItem(4, sContinue, &ReturnGame);
+    pMainMenu_->AddItem(5, sSaveGame, &SaveGame);
+}
+
+std::string Application::GetSlotFile_( const uint_t& uiSlot ) const
+{
+    return SAVE_DIRECTORY + "/slot" + ToString(uiSlot + 1) + ".sav";
+}
+
+void Application::UpdateSlots_()
+{
+    for (uint_t i = 0; i < SLOT_COUNT; ++i)
+    {
+        // Only peek at the name : errors are reported when the slot is loaded
+        std::string sName = "?";
+        bool bUsed = FileExists(GetSlotFile_(i));
+        if (bUsed)
+            SaveFile::ReadName(GetSlotFile_(i), sName);
+
+        lSaveSlotList_[i]->SetCaption(ToString(i + 1) + ". " + (bUsed ? sName : "-"));
+
+        // Only non empty slots can be loaded
+        if (mState_ == STATE_LOAD && !bUsed)
+            lSaveSlotList_[i]->Disable();
+        else
+            lSaveSlotList_[i]->Enable();
+    }
+}
+
+void Application::SaveOnSlot( const uint_t& uiSlot )
+{
+    if (mState_ == STATE_SAVE)
+    {
+        char sName[32];
+        std::time_t mTime = std::time(nullptr);
+        std::strftime(sName, sizeof(sName), "%d/%m %H:%M", std::localtime(&mTime));
+
+        SaveSlot_(uiSlot, sName);
+    }
+    else if (mState_ == STATE_LOAD)
+        LoadSlot_(uiSlot);
+}
+
 void Application::SaveSlot_( const uint_t& uiSlot, const std::string& sName )
 {
+    if (!pBoard_)
+        return;
+
+    SaveData mData;
+    mData.sName = sName;
+    mData.uiOpponent = mOpponent_;
+    mData.mGame = pBoard_->GetGame();
+    mData.lHistory = pBoard_->GetHistory().GetMoveList();
+
+    if (!MakeDirectory(SAVE_DIRECTORY))
+    {
+        Error(CLASS_NAME, "Cannot create the \""+SAVE_DIRECTORY+"\" directory.");
+        return;
+    }
 
+    if (SaveFile::Write(GetSlotFile_(uiSlot), mData))
+        SetState(STATE_GAME);
 }
 
 void Application::LoadSlot_( const uint_t& uiSlot )
 {
+    SaveData mData;
+    if (!SaveFile::Read(GetSlotFile_(uiSlot), mData))
+        return;
+
+    // Keep the current board if any : only the orbs need to move
+    if (!pBoard_)
+        CreateBoard_();
+
+    // A network game is resumed on this computer
+    mOpponent_ = mData.uiOpponent <= OPPONENT_MCTS ? (Opponent)mData.uiOpponent : OPPONENT_HUMAN;
+    pBoard_->LoadGame(mData.mGame, mData.lHistory, mOpponent_);
 
+    SetState(STATE_GAME);
+}
+
+void Application::StartNetworkGame( bool bHost )
+{
+    pNetwork_ = std::unique_ptr<NetworkPlayer>(new NetworkPlayer());
+
+    if (bHost)
+    {
+        if (pNetwork_->Host())
+            pNetworkText_->SetText(Replace(sWaitingPlayer_, "[PORT]", ToString(NetProtocol::DEFAULT_PORT)));
+        else
+            pNetworkText_->SetText(sConnectionFailed_);
+    }
+    else
+    {
+        pNetwork_->Join(sAddress_);
+        pNetworkText_->SetText(sConnecting_);
+    }
+}
+
+void Application::UpdateNetwork_( float fDelta )
+{
+    InputManager* pInputMgr = InputManager::GetSingleton();
+
+    // Type the address of the host : letters, digits, dots and dashes
+    static const std::string sKeyChars = "abcdefghijklmnopqrstuvwxyz0123456789";
+    for (uint_t i = 0; i < sKeyChars.size(); ++i)
+    {
+        if (pInputMgr->KeyIsPressed((KeyCode)(KEY_A + i)))
+            sAddress_ += sKeyChars[i];
+    }
+
+    for (uint_t i = 0; i < 10; ++i)
+    {
+        if (pInputMgr->KeyIsPressed((KeyCode)(KEY_NUM0 + i)))
+            sAddress_ += char('0' + i);
+    }
+
+    if (pInputMgr->KeyIsPressed(KEY_PERIOD))
+        sAddress_ += '.';
+    if (pInputMgr->KeyIsPressed(KEY_DASH))
+        sAddress_ += '-';
+    if (pInputMgr->KeyIsPressed(KEY_BACK) && !sAddress_.empty())
+        sAddress_.erase(sAddress_.size() - 1);
+
+    pAddressText_->SetText(sAddressLabel_ + sAddress_);
+    pAddressText_->Render(512, 300);
+
+    Vector2D mMouse(pInputMgr->GetMousePosX(), pInputMgr->GetMousePosY());
+    for (auto pButton : {pHostButton_.get(), pJoinButton_.get()})
+    {
+        pButton->Update(fDelta, mMouse, pInputMgr->MouseIsDown(MOUSE_LEFT), pInputMgr->MouseIsReleased(MOUSE_LEFT));
+        pButton->Render();
+    }
+
+    pNetworkText_->Render(512, 530);
+
+    if (!pNetwork_)
+        return;
+
+    // Never blocks : the connection is polled once per frame
+    pNetwork_->Update();
+
+    if (pNetwork_->GetState() == NetworkPlayer::STATE_READY)
+    {
+        CreateBoard_();
+        pBoard_->SetNetwork(std::move(pNetwork_));
+        mOpponent_ = OPPONENT_NETWORK;
+        SetState(STATE_GAME);
+    }
+    else if (pNetwork_->GetState() == NetworkPlayer::STATE_CLOSED)
+    {
+        pNetwork_ = nullptr;
+        pNetworkText_->SetText(sConnectionFailed_);
+    }
 }
@@ -6,6 +6,13 @@
 #include "text.h"
 #include "inputmanager.h"
 #include "application.h"
+#include "log.h"
+#include "aiplayer.h"
+#include "mctsplayer.h"
+#include "movegenerator.h"
+#include "networkplayer.h"
+
+const std::string Board::CLASS_NAME = "Board";
 
 void Player1Button(Application& mApp)
 {
@@ -37,17 +44,22 @@ Board::Board( const Vector2D& mPos, Application& mApp ) : mApp_(mApp), mPosition
         sPlayer = "Joueur";
         sEndTurn = "Fin du tour";
         sWaitPlayer = "Attente joueur";
+        sReplay_ = "Revue : tour [PLY] / [COUNT]";
     }
     else if (mApp_.GetLanguage() == "en")
     {
         sPlayer = "Player";
         sEndTurn = "End turn";
         sWaitPlayer = "Wait for player";
+        sReplay_ = "Replay : turn [PLY] / [COUNT]";
     }
 
     pWinText_ = std::unique_ptr<Text>(new Text("ravie.ttf", 36));
     pWinText_->SetAlignment(Text::ALIGN_CENTER);
 
+    pReplayText_ = std::unique_ptr<Text>(new Text("ravie.ttf", 24));
+    pReplayText_->SetAlignment(Text::ALIGN_CENTER);
+
     pPlayer1Text_ = std::unique_ptr<Text>(new Text("ravie.ttf", 24));
     pPlayer1Text_->SetText(sPlayer+" 1 : ");
 
@@ -68,6 +80,7 @@ Board::Board( const Vector2D& mPos, Application& mApp ) : mApp_(mApp), mPosition
 
 Board::~Board()
 {
+    StopComputer_();
 }
 
 void Board::CreateGrid_()
@@ -77,6 +90,8 @@ void Board::CreateGrid_()
     pHomeGrid_ = std::unique_ptr<Sprite>(new Sprite("grid_home.png"));
     pHomeGrid_->SetHotSpot(32, 32);
 
+    lSlotTileList_.fill(nullptr);
+
     for (int i = 0; i < 10; ++i)
     {
         for (int j = 0; j < 10; ++j)
@@ -87,89 +102,86 @@ void Board::CreateGrid_()
             if (1 < i && i < 8)
             {
                 if (j < 2)
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::HOME_RED)));
+                    AddTile_(Slot(i, j), Tile::HOME_RED);
                 else if (j > 7)
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::HOME_BLUE)));
+                    AddTile_(Slot(i, j), Tile::HOME_BLUE);
                 else
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::NORMAL)));
+                    AddTile_(Slot(i, j), Tile::NORMAL);
             }
             else if (1 < j && j < 8)
             {
                 if (i < 2)
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::HOME_PINK)));
+                    AddTile_(Slot(i, j), Tile::HOME_PINK);
                 else if (i > 7)
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::HOME_GREEN)));
+                    AddTile_(Slot(i, j), Tile::HOME_GREEN);
                 else
-                    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::NORMAL)));
+                    AddTile_(Slot(i, j), Tile::NORMAL);
             }
             else
-                lTileList_.push_back(std::unique_ptr<Tile>(new Tile(Slot(i, j), Tile::NORMAL)));
+                AddTile_(Slot(i, j), Tile::NORMAL);
         }
     }
+}
 
-    for (auto& tile1 : lTileList_)
+void Board::RenderGrid_()
+{
+    // The grid never changes : build the batch once
+    if (mGridBatch_.IsEmpty())
     {
-        for (auto& tile2 : lTileList_)
+        for (int i = 0; i < 10; ++i)
         {
-            if (tile1 != tile2)
+            for (int j = 0; j < 10; ++j)
             {
-                Slot mDist = tile1->GetSlot() - tile2->GetSlot();
-                if (std::fabs(mDist.X()) <= 1 && std::fabs(mDist.Y()) <= 1)
-                {
-                    tile1->AddNeighbor(tile2.get());
-                    tile2->AddNeighbor(tile1.get());
-                }
+                if ((i < 2 && (j < 2 || j > 7)) || (i > 7  && (j < 2 || j > 7)))
+                    continue;
+
+                if (i < 2 || i > 7 || j < 2 || j > 7)
+                    pHomeGrid_->Render(mGridBatch_, i*64 + mPosition_.X(), j*64 + mPosition_.Y());
             }
         }
-    }
-}
 
-void Board::RenderGrid_()
-{
-    for (int i = 0; i < 10; ++i)
-    {
-        for (int j = 0; j < 10; ++j)
+        for (int i = 2; i < 8; ++i)
         {
-            if ((i < 2 && (j < 2 || j > 7)) || (i > 7  && (j < 2 || j > 7)))
-                continue;
-
-            if (i < 2 || i > 7 || j < 2 || j > 7)
-                pHomeGrid_->Render(i*64 + mPosition_.X(), j*64 + mPosition_.Y());
-            else
-                pNormalGrid_->Render(i*64 + mPosition_.X(), j*64 + mPosition_.Y());
+            for (int j = 2; j < 8; ++j)
+                pNormalGrid_->Render(mGridBatch_, i*64 + mPosition_.X(), j*64 + mPosition_.Y());
         }
     }
+
+    mGridBatch_.Render();
 }
 
 void Board::CreateOrbs_()
 {
-    for (int i = 2; i < 8; ++i)
-    {
-        for (int j = 0; j < 2; ++j)
-            AddOrb_(Slot(i, j), Orb::BLUE);
-
-        for (uint_t j = 8; j < 10; ++j)
-            AddOrb_(Slot(i, j), Orb::RED);
-    }
-
-    for (int j = 2; j < 8; ++j)
-    {
-        for (int i = 0; i < 2; ++i)
-            AddOrb_(Slot(i, j), Orb::GREEN);
+    // Orbs are created in the same order as in the game state,
+    // so they share the same index
+    for (uint_t i = 0; i < GameState::ORB_COUNT; ++i)
+        AddOrb_(mGame_.GetOrbSlot(i), mGame_.GetOrbColor(i));
 
-        for (int i = 8; i < 10; ++i)
-            AddOrb_(Slot(i, j), Orb::PINK);
-    }
-
-    bUpdateMovements_ = true;
+    mChangedSlots_ = MoveGenerator::GetBoardMask();
 }
 
 void Board::RenderOrbs_()
 {
+    mOrbBatch_.Clear();
+
     for (auto& pOrb : lOrbList_)
+        pOrb->RenderMovements(mOrbBatch_);
+
+    // Group the orbs by color so that each texture is only bound once,
+    // and draw the dragged orb last so that it stays on top
+    for (uint_t uiType = 0; uiType < 4; ++uiType)
     {
-        pOrb->Render();
+        for (auto& pOrb : lOrbList_)
+        {
+            if ((uint_t)pOrb->GetType() == uiType && pOrb.get() != pDraggedOrb_)
+                pOrb->Render(mOrbBatch_);
+        }
     }
+
+    if (pDraggedOrb_)
+        pDraggedOrb_->Render(mOrbBatch_);
+
+    mOrbBatch_.Render();
 }
 
 
@@ -184,9 +196,15 @@ void Board::Render()
     pPlayer1Button_->Render();
     pPlayer2Button_->Render();
 
+    if (bReplay_)
+    {
+        pReplayText_->Render(512, 730);
+        return;
+    }
+
     if ( (mState_ == STATE_VICTORY1) || (mState_ == STATE_VICTORY2) )
     {
-        mApp_.GetRenderWindow()->draw(mRect_);
+        mApp_.Draw(mRect_);
         pWinText_->Render(512, 384);
     }
 }
@@ -196,44 +214,58 @@ void Board::Update(float fDelta)
     InputManager* pInputMgr = InputManager::GetSingleton();
     Vector2D mMouse = Vector2D(pInputMgr->GetMousePosX(), pInputMgr->GetMousePosY());
 
+    if (pNetwork_)
+        UpdateNetwork_();
+
+    if (pInputMgr->KeyIsPressed(KEY_R) && !bDrag_)
+        SetReplay_(!bReplay_);
+
+    // The game is paused during the replay (the computer's move is played when it ends)
+    if (bReplay_)
+    {
+        UpdateReplay_();
+        return;
+    }
+
     pPlayer1Button_->Update(fDelta, mMouse, pInputMgr->MouseIsDown(MOUSE_LEFT), pInputMgr->MouseIsReleased(MOUSE_LEFT));
     pPlayer2Button_->Update(fDelta, mMouse, pInputMgr->MouseIsDown(MOUSE_LEFT), pInputMgr->MouseIsReleased(MOUSE_LEFT));
 
-    pMouseOveredOrb_ = nullptr;
-    for (auto& pOrb : lOrbList_)
+    // The computer searches in a separate thread, check if it is done
+    if (mComputerMove_.valid() && mComputerMove_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        PlayComputerMove_();
+
+    // Orbs lie on their slot, except the dragged one : only the orb of the
+    // slot under the mouse can contain it
+    Orb* pHoveredOrb = GetOrb_(GetSlotAt_(mMouse));
+    if (pHoveredOrb == pDraggedOrb_ || (pHoveredOrb && !pHoveredOrb->Contains(mMouse)))
+        pHoveredOrb = nullptr;
+
+    if (pHoveredOrb != pMouseOveredOrb_)
     {
-        if (pDraggedOrb_ == pOrb.get())
-            continue;
+        if (pMouseOveredOrb_ && pMouseOveredOrb_ != pDraggedOrb_)
+            pMouseOveredOrb_->NotifyMouseOver(false);
 
-        if (pOrb->Contains(mMouse))
-        {
-            pOrb->NotifyMouseOver(true);
-            pMouseOveredOrb_ = pOrb.get();
-        }
-        else
-            pOrb->NotifyMouseOver(false);
+        if (pHoveredOrb)
+            pHoveredOrb->NotifyMouseOver(true);
+
+        pMouseOveredOrb_ = pHoveredOrb;
     }
 
     if (pInputMgr->MouseIsPressed(MOUSE_LEFT))
     {
-        if (pMouseOveredOrb_ && (!pMovedOrb_ || pMovedOrb_ == pMouseOveredOrb_))
+        // Pick the orb that was under the mouse when the button was pressed :
+        // at low frame rates, the mouse may have left it since
+        Vector2D mPressed = Vector2D(pInputMgr->GetMouseButtonPosX(MOUSE_LEFT), pInputMgr->GetMouseButtonPosY(MOUSE_LEFT));
+        Orb* pPressedOrb = GetOrb_(GetSlotAt_(mPressed));
+        if (pPressedOrb && !pPressedOrb->Contains(mPressed))
+            pPressedOrb = nullptr;
+
+        if (pPressedOrb && !IsComputerTurn_() && !IsRemoteTurn_() && mGame_.CanPlay(mGame_.GetOrbAt(pPressedOrb->GetSlot())))
         {
-            if ((mState_ == STATE_PLAYER1 &&
-                  ((pMouseOveredOrb_->GetType() == Orb::RED) ||
-                   (pMouseOveredOrb_->GetType() == Orb::BLUE))) ||
-                (mState_ == STATE_PLAYER2 &&
-                  ((pMouseOveredOrb_->GetType() == Orb::GREEN) ||
-                   (pMouseOveredOrb_->GetType() == Orb::PINK))))
-            {
-                bDrag_ = true;
-                pDraggedOrb_ = pMouseOveredOrb_;
-                pDraggedOrb_->NotifyDragged(true);
-                mInitialDragPos_ = pDraggedOrb_->GetPosition();
-
-                if (!pMovedOrb_)
-                    mInitialSlot_ = pDraggedOrb_->GetSlot();
-            }
-
+            bDrag_ = true;
+            pDraggedOrb_ = pPressedOrb;
+            pDraggedOrb_->NotifyDragged(true);
+            mInitialDragPos_ = pDraggedOrb_->GetPosition();
         }
     }
 
@@ -241,6 +273,11 @@ void Board::Update(float fDelta)
     {
         if (pMouseOveredOrb_ && pMouseOveredOrb_== pMovedOrb_)
         {
+            mGame_.CancelMove();
+
+            mChangedSlots_.Set(BitBoard::GetIndex(mInitialSlot_));
+            mChangedSlots_.Set(BitBoard::GetIndex(pMovedOrb_->GetSlot()));
+
             GetTile_(mInitialSlot_)->SetOrb(pMovedOrb_);
             GetTile_(pMovedOrb_->GetSlot())->SetOrb(nullptr);
 
@@ -249,8 +286,7 @@ void Board::Update(float fDelta)
                 mInitialSlot_
             );
 
-            pMovedOrb_ = nullptr;
-            bUpdateMovements_ = true;
+            UpdateMovedOrb_();
         }
     }
 
@@ -263,146 +299,478 @@ void Board::Update(float fDelta)
     {
         if (bDrag_)
         {
-            Vector2D mNormalized = (mMouse - mPosition_ + Vector2D(32, 32))/64.0f;
-            mNormalized.X() = std::floor(mNormalized.X());
-            mNormalized.Y() = std::floor(mNormalized.Y());
+            // Drop the orb where the button was released
+            Vector2D mReleased = Vector2D(pInputMgr->GetMouseButtonPosX(MOUSE_LEFT), pInputMgr->GetMouseButtonPosY(MOUSE_LEFT));
+            if (!MoveOrb_(pDraggedOrb_, GetSlotAt_(mReleased)))
+                pDraggedOrb_->SetPosition(mInitialDragPos_, pDraggedOrb_->GetSlot());
 
-            Slot mSlot;
-            mSlot.X() = int(mNormalized.X());
-            mSlot.Y() = int(mNormalized.Y());
+            bDrag_ = false;
+            pDraggedOrb_->NotifyDragged(false);
+            pDraggedOrb_->NotifyMouseOver(false);
+            pDraggedOrb_ = nullptr;
+        }
+    }
 
-            bool bObstructed_ = false;
+    if (!mChangedSlots_.IsEmpty())
+        UpdateMovements_();
+}
 
-            // Check we're still on the board
-            if ((!IsInRange(mSlot.X(), 0, 9) || !IsInRange(mSlot.Y(), 0, 9)) ||
-                (!IsInRange(mSlot.X(), 2, 7) && !IsInRange(mSlot.Y(), 2, 7)))
-                bObstructed_ = true;
+void Board::UpdateMovements_()
+{
+    for (auto& pOrb : lOrbList_)
+    {
+        if (pOrb.get() == pMovedOrb_)
+            continue;
 
-            // Check if there is already an orb here
-            if (!bObstructed_)
-            {
-                for (auto& pOrb : lOrbList_)
-                {
-                    if (pOrb->IsOnSlot(mSlot))
-                        bObstructed_ = true;
-                }
-            }
+        // The movements of an orb can only change if it moved, or if an
+        // orb entered or left one of the slots it looked at to compute them
+        Tile* pTile = GetTile_(pOrb->GetSlot());
+        if (!mChangedSlots_.Test(BitBoard::GetIndex(pOrb->GetSlot())) &&
+            (pTile->GetDependencies() & mChangedSlots_).IsEmpty())
+            continue;
 
-            if (bObstructed_ || !pDraggedOrb_->CanMoveTo(mSlot))
-            {
-                mNormalized = (mInitialDragPos_ - mPosition_)/64.0f;
-                mSlot.X() = int(mNormalized.X());
-                mSlot.Y() = int(mNormalized.Y());
-                pDraggedOrb_->SetPosition(mInitialDragPos_, mSlot);
-            }
-            else
-            {
-                mPreviousSlot_ = pDraggedOrb_->GetSlot();
+        pTile->ComputeAvailableMovements(mGame_.GetOccupied());
+        pOrb->NotifyAvailableMovements(pTile->GetAvailableMovements());
+    }
 
-                Vector2D mNewPos = mNormalized*64.0f + mPosition_;
-                pDraggedOrb_->SetPosition(mNewPos, mSlot);
+    mChangedSlots_ = BitBoard();
 
-                if (mSlot == mInitialSlot_)
-                    pMovedOrb_ = nullptr;
-                else
-                    pMovedOrb_ = pDraggedOrb_;
-
-                GetTile_(mSlot)->SetOrb(pDraggedOrb_);
-                mNormalized = (mInitialDragPos_ - mPosition_)/64.0f;
-                mSlot.X() = int(mNormalized.X());
-                mSlot.Y() = int(mNormalized.Y());
-                GetTile_(mSlot)->SetOrb(nullptr);
-
-                std::array<uint_t, 4> lOrbCount;
-                for (auto& pOrb : lOrbList_)
-                {
-                    if (pOrb->IsWellPlaced())
-                        ++lOrbCount[pOrb->GetType()];
-                }
-
-                if ( (lOrbCount[Orb::GREEN] == 12) && (lOrbCount[Orb::PINK] == 12) )
-                {
-                    SetState(STATE_VICTORY2);
-                    pMouseOveredOrb_->NotifyMouseOver(false);
-                }
-                else if ( (lOrbCount[Orb::RED] == 12) && (lOrbCount[Orb::BLUE] == 12) )
-                {
-                    SetState(STATE_VICTORY1);
-                    pMouseOveredOrb_->NotifyMouseOver(false);
-                }
-
-                bUpdateMovements_ = true;
-            }
+#ifdef ORB_CHECK_MOVEMENTS
+    CheckMovements_();
+#endif
+}
 
-            bDrag_ = false;
-            pDraggedOrb_->NotifyDragged(false);
-            pDraggedOrb_ = nullptr;
+#ifdef ORB_CHECK_MOVEMENTS
+void Board::CheckMovements_()
+{
+    for (auto& pOrb : lOrbList_)
+    {
+        if (pOrb.get() == pMovedOrb_)
+            continue;
+
+        uint_t uiIndex = BitBoard::GetIndex(pOrb->GetSlot());
+        BitBoard mExpected = MoveGenerator::GetMovements(mGame_.GetOccupied(), uiIndex);
+        mExpected.Set(uiIndex);
+
+        BitBoard mActual;
+        for (auto& mSlot : GetTile_(pOrb->GetSlot())->GetAvailableMovements())
+            mActual.Set(BitBoard::GetIndex(mSlot));
+
+        if (mActual != mExpected)
+        {
+            Error(CLASS_NAME, "Outdated movements for the orb at ("+
+                ToString(pOrb->GetSlot().X())+", "+ToString(pOrb->GetSlot().Y())+").");
         }
     }
+}
+#endif
+
+bool Board::MoveOrb_(Orb* pOrb, const Slot& mSlot)
+{
+    Slot mOldSlot = pOrb->GetSlot();
+
+    // The game state checks that we're still on the board, that there
+    // is no orb on this slot, and that this orb is allowed to go there
+    if (!mGame_.MoveOrb(mGame_.GetOrbAt(mOldSlot), mSlot))
+        return false;
+
+    mPreviousSlot_ = mOldSlot;
+
+    pOrb->SetPosition(Vector2D(64.0f*mSlot.X(), 64.0f*mSlot.Y()) + mPosition_, mSlot);
+
+    GetTile_(mSlot)->SetOrb(pOrb);
+    GetTile_(mOldSlot)->SetOrb(nullptr);
+
+    mChangedSlots_.Set(BitBoard::GetIndex(mOldSlot));
+    mChangedSlots_.Set(BitBoard::GetIndex(mSlot));
+
+    UpdateMovedOrb_();
+
+    if (mGame_.IsOver())
+    {
+        RecordTurn_();
+        SetState((State)mGame_.GetState());
+        pOrb->NotifyMouseOver(false);
+    }
+
+    return true;
+}
+
+void Board::RecordTurn_()
+{
+    Move mMove;
+    uint_t uiMovedOrb = mGame_.GetMovedOrb();
+    if (uiMovedOrb != npos)
+        mMove = Move(BitBoard::GetIndex(mGame_.GetInitialSlot()), mGame_.GetOrbIndex(uiMovedOrb));
+
+    uint_t uiPly = mHistory_.GetSize();
+    if (!mHistory_.Push(mMove))
+        Error(CLASS_NAME, "Cannot record the last turn, the history is out of sync.");
+
+    // mState_ is still the player who just played
+    if (pNetwork_ && !IsRemoteTurn_())
+        pNetwork_->SendMove(uiPly, mMove);
+}
+
+void Board::StopComputer_()
+{
+    if (mComputerMove_.valid())
+    {
+        pComputer_->Stop();
+        mComputerMove_.wait();
+        mComputerMove_ = std::future<Move>();
+    }
+}
+
+const GameState& Board::GetGame() const
+{
+    return mGame_;
+}
+
+const MoveHistory& Board::GetHistory() const
+{
+    return mHistory_;
+}
+
+void Board::LoadGame(const GameState& mGame, const std::vector<Move>& lHistory, Application::Opponent mOpponent)
+{
+    StopComputer_();
+
+    if (pDraggedOrb_)
+    {
+        pDraggedOrb_->NotifyDragged(false);
+        pDraggedOrb_ = nullptr;
+        bDrag_ = false;
+    }
+
+    if (pMouseOveredOrb_)
+    {
+        pMouseOveredOrb_->NotifyMouseOver(false);
+        pMouseOveredOrb_ = nullptr;
+    }
+
+    bReplay_ = false;
+    mGame_ = mGame;
+
+    // Replay the turns to rebuild the history : they must lead to the
+    // saved position (before the orb moved during this turn, if any)
+    GameState mTurnStart = mGame_;
+    mTurnStart.CancelMove();
+
+    mHistory_.Clear();
+    for (auto& mMove : lHistory)
+    {
+        if (!mHistory_.Push(mMove))
+            break;
+    }
+
+    const GameState& mLastPosition = mHistory_.GetLastPosition();
+    if (mHistory_.GetSize() != lHistory.size() || mLastPosition.GetHash() != mTurnStart.GetHash() ||
+        mLastPosition.GetState() != mTurnStart.GetState())
+    {
+        Warning(CLASS_NAME, "The saved turns don't lead to the saved position, the replay is not available.");
+        mHistory_.Clear();
+    }
+
+    PlaceOrbs_(mGame_);
+    UpdateMovedOrb_();
+
+    // The moved orb can go back to its initial slot, or anywhere it could reach from there
+    if (pMovedOrb_)
+    {
+        std::vector<Slot> lMovementList = {pMovedOrb_->GetSlot()};
+        BitBoard mMovements = mGame_.GetMovements(mGame_.GetMovedOrb());
+        while (!mMovements.IsEmpty())
+            lMovementList.push_back(BitBoard::GetSlot(mMovements.PopFirst()));
+
+        pMovedOrb_->NotifyAvailableMovements(lMovementList);
+    }
+
+    mChangedSlots_ = MoveGenerator::GetBoardMask();
+    UpdateMovements_();
+
+    // The computer must see whose turn it is in the loaded game
+    mState_ = (State)mGame_.GetState();
+    SetOpponent(mOpponent);
+    SetState((State)mGame_.GetState());
+}
+
+void Board::PlaceOrbs_(const GameState& mGame)
+{
+    // Move the orbs where they belong, the sprites are kept
+    for (auto& pTile : lTileList_)
+        pTile->SetOrb(nullptr);
+
+    for (uint_t i = 0; i < GameState::ORB_COUNT; ++i)
+    {
+        Slot mSlot = mGame.GetOrbSlot(i);
+        Orb* pOrb = lOrbList_[i].get();
+        pOrb->SetPosition(Vector2D(64.0f*mSlot.X(), 64.0f*mSlot.Y()) + mPosition_, mSlot);
+        GetTile_(mSlot)->SetOrb(pOrb);
+    }
+}
+
+void Board::SetReplay_(bool bReplay)
+{
+    if (bReplay == bReplay_)
+        return;
+
+    bReplay_ = bReplay;
+
+    if (pMouseOveredOrb_)
+    {
+        pMouseOveredOrb_->NotifyMouseOver(false);
+        pMouseOveredOrb_ = nullptr;
+    }
+
+    if (bReplay_)
+        ShowReplayPly_(mHistory_.GetSize());
+    else
+    {
+        // Back to the game : the tiles have seen other positions
+        PlaceOrbs_(mGame_);
+        mChangedSlots_ = MoveGenerator::GetBoardMask();
+    }
+}
+
+void Board::UpdateReplay_()
+{
+    InputManager* pInputMgr = InputManager::GetSingleton();
+
+    uint_t uiPly = uiReplayPly_;
+    uint_t uiSize = mHistory_.GetSize();
+
+    if (pInputMgr->KeyIsPressed(KEY_LEFT) && uiPly > 0)
+        --uiPly;
+    if (pInputMgr->KeyIsPressed(KEY_RIGHT) && uiPly < uiSize)
+        ++uiPly;
+    if (pInputMgr->KeyIsPressed(KEY_PAGEUP))
+        uiPly -= std::min(uiPly, uint_t(10));
+    if (pInputMgr->KeyIsPressed(KEY_PAGEDOWN))
+        uiPly = std::min(uiPly + 10, uiSize);
+    if (pInputMgr->KeyIsPressed(KEY_HOME))
+        uiPly = 0;
+    if (pInputMgr->KeyIsPressed(KEY_END))
+        uiPly = uiSize;
+
+    if (uiPly != uiReplayPly_)
+        ShowReplayPly_(uiPly);
+}
+
+void Board::ShowReplayPly_(uint_t uiPly)
+{
+    uiReplayPly_ = uiPly;
+    mHistory_.GetPosition(uiPly, mReplayGame_);
+    PlaceOrbs_(mReplayGame_);
+
+    pReplayText_->SetText(Replace(Replace(sReplay_,
+        "[PLY]", ToString(uiPly)), "[COUNT]", ToString(mHistory_.GetSize())));
+}
+
+void Board::SetOpponent(Application::Opponent mOpponent)
+{
+    StopComputer_();
+
+    if (mOpponent != Application::OPPONENT_NETWORK)
+        pNetwork_ = nullptr;
+
+    switch (mOpponent)
+    {
+        case Application::OPPONENT_HUMAN :
+        case Application::OPPONENT_NETWORK :
+            pComputer_ = nullptr;
+            break;
+        case Application::OPPONENT_ALPHABETA :
+            pComputer_ = std::unique_ptr<ComputerPlayer>(new AIPlayer());
+            break;
+        case Application::OPPONENT_MCTS :
+            pComputer_ = std::unique_ptr<ComputerPlayer>(new MCTSPlayer());
+            break;
+    }
+
+    if (IsComputerTurn_())
+        StartComputerTurn_();
+}
+
+void Board::SetNetwork(std::unique_ptr<NetworkPlayer> pNetwork)
+{
+    SetOpponent(Application::OPPONENT_NETWORK);
+    pNetwork_ = std::move(pNetwork);
+
+    // Update the buttons : the other player's one is never enabled
+    SetState(mState_);
+}
+
+bool Board::IsRemoteTurn_() const
+{
+    if (!pNetwork_)
+        return false;
+
+    return mState_ == (pNetwork_->GetLocalPlayer() == 0 ? STATE_PLAYER2 : STATE_PLAYER1);
+}
+
+void Board::UpdateNetwork_()
+{
+    pNetwork_->Update();
 
-    if (bUpdateMovements_)
+    // Like the computer's move, the other player's turn waits for the end of the replay
+    NetMessage mMessage;
+    while (!bReplay_ && pNetwork_->PopMove(mMessage))
     {
-        for (auto& pTile : lTileList_)
+        if (!PlayRemoteMove_(mMessage))
         {
-            if (pTile->IsOccupied())
-            {
-                Orb* pOrb = pTile->GetOrb();
-                if (pOrb != pMovedOrb_)
-                {
-                    pTile->ComputeAvailableMovements();
-                    pOrb->NotifyAvailableMovements(pTile->GetAvailableMovements());
-                }
-            }
+            Error(CLASS_NAME, "The other player sent a turn that the rules don't allow.");
+            pNetwork_->Close();
+            break;
         }
+    }
 
-        bUpdateMovements_ = false;
+    if (pNetwork_->GetState() == NetworkPlayer::STATE_CLOSED)
+    {
+        Warning(CLASS_NAME, "The connection is closed, the game continues on this computer.");
+        pNetwork_ = nullptr;
+        SetState(mState_);
     }
 }
 
-void Board::SetState(State mState)
+bool Board::PlayRemoteMove_(const NetMessage& mMessage)
 {
-    mState_ = mState;
+    // Never trust the other side : it must be its turn, both games must
+    // agree on the number of turns played, and the move must be allowed
+    if (!IsRemoteTurn_() || mMessage.uiPly != (mHistory_.GetSize() & 0xFFFF) || pMovedOrb_)
+        return false;
 
-    if (mState_ == STATE_PLAYER1 || mState_ == STATE_PLAYER2)
+    const Move& mMove = mMessage.mMove;
+    if (mMove != Move())
     {
+        uint_t uiOrb = mGame_.GetOrbAt(uint_t(mMove.uiFrom));
+        if (uiOrb == npos || !MoveOrb_(lOrbList_[uiOrb].get(), BitBoard::GetSlot(mMove.uiTo)))
+            return false;
+    }
+
+    if (!mGame_.IsOver())
+        SetState(mState_ == STATE_PLAYER1 ? STATE_PLAYER2 : STATE_PLAYER1);
+
+    return true;
+}
+
+bool Board::IsComputerTurn_() const
+{
+    return pComputer_ && mState_ == STATE_PLAYER2;
+}
+
+void Board::StartComputerTurn_()
+{
+    if (mComputerMove_.valid())
+        return;
+
+    // Search on a copy of the game, so the render loop is never blocked
+    GameState mGame = mGame_;
+    pComputer_->ClearStop();
+    mComputerMove_ = std::async(std::launch::async, [this, mGame]() {
+        return pComputer_->Search(mGame);
+    });
+}
+
+void Board::PlayComputerMove_()
+{
+    Move mMove = mComputerMove_.get();
+
+    // The search is stale if the game changed meanwhile
+    if (!IsComputerTurn_())
+        return;
+
+    const SearchInfo& mInfo = pComputer_->GetLastSearchInfo();
+    Log("Computer played at depth "+ToString(mInfo.uiDepth)+" ("+ToString(mInfo.uiNodes)+" nodes in "+
+        ToString(mInfo.fTime)+" s, "+ToString(uint_t(mInfo.fNodesPerSecond))+" nodes/s on "+
+        ToString(mInfo.uiThreadCount)+" threads, score : "+ToString(mInfo.iScore)+")");
+
+    // No move found : the computer passes
+    if (mMove != Move())
+    {
+        Orb* pOrb = lOrbList_[mGame_.GetOrbAt(uint_t(mMove.uiFrom))].get();
+        MoveOrb_(pOrb, BitBoard::GetSlot(mMove.uiTo));
+    }
+
+    if (!mGame_.IsOver())
+        SetState(STATE_PLAYER1);
+}
+
+void Board::SetState(State mState)
+{
+    if ((mState == STATE_PLAYER1 || mState == STATE_PLAYER2) && (State)mGame_.GetState() != mState)
+    {
+        RecordTurn_();
+        mGame_.EndTurn();
+
         if (pMovedOrb_)
         {
             Tile* pTile = GetTile_(pMovedOrb_->GetSlot());
-            pTile->ComputeAvailableMovements();
+            pTile->ComputeAvailableMovements(mGame_.GetOccupied());
             pMovedOrb_->NotifyAvailableMovements(pTile->GetAvailableMovements());
-            pMovedOrb_ = nullptr;
+            UpdateMovedOrb_();
         }
     }
 
+    mState_ = (State)mGame_.GetState();
+
     std::string sWin;
     std::string sEndTurn;
     std::string sWaitPlayer;
+    std::string sComputer;
+    std::string sRemote;
     if (mApp_.GetLanguage() == "fr")
     {
         sWin = "Le joueur [PLAYER] gagne la partie !";
         sEndTurn = "Fin du tour";
         sWaitPlayer = "Attente joueur";
+        sComputer = "Tour de l'ordinateur";
+        sRemote = "Tour de l'adversaire";
     }
     else if (mApp_.GetLanguage() == "en")
     {
         sWin = "Player [PLAYER] won the game!";
         sEndTurn = "End turn";
         sWaitPlayer = "Wait for player";
+        sComputer = "Computer's turn";
+        sRemote = "Opponent's turn";
     }
 
     switch (mState_)
     {
         case STATE_PLAYER1 :
-            pPlayer1Button_->SetCaption(sEndTurn);
-            pPlayer1Button_->Enable();
+            if (IsRemoteTurn_())
+            {
+                pPlayer1Button_->SetCaption(sRemote);
+                pPlayer1Button_->Disable();
+            }
+            else
+            {
+                pPlayer1Button_->SetCaption(sEndTurn);
+                pPlayer1Button_->Enable();
+            }
             pPlayer2Button_->SetCaption(sWaitPlayer+" 1");
             pPlayer2Button_->Disable();
             break;
         case STATE_PLAYER2 :
             pPlayer1Button_->SetCaption(sWaitPlayer+" 2");
             pPlayer1Button_->Disable();
-            pPlayer2Button_->SetCaption(sEndTurn);
-            pPlayer2Button_->Enable();
+            if (pComputer_)
+            {
+                pPlayer2Button_->SetCaption(sComputer);
+                pPlayer2Button_->Disable();
+                StartComputerTurn_();
+            }
+            else if (IsRemoteTurn_())
+            {
+                pPlayer2Button_->SetCaption(sRemote);
+                pPlayer2Button_->Disable();
+            }
+            else
+            {
+                pPlayer2Button_->SetCaption(sEndTurn);
+                pPlayer2Button_->Enable();
+            }
             break;
         case STATE_VICTORY1 :
             pWinText_->SetText(Replace(sWin, "[PLAYER]", "1"));
@@ -423,15 +791,43 @@ void Board::AddOrb_(const Slot& mSlot, uint_t uiType)
     GetTile_(mSlot)->SetOrb(lOrbList_.back().get());
 }
 
-Tile* Board::GetTile_(const Slot& mSlot)
+void Board::UpdateMovedOrb_()
 {
-    for (auto& pTile : lTileList_)
+    uint_t uiMovedOrb = mGame_.GetMovedOrb();
+    if (uiMovedOrb == npos)
+        pMovedOrb_ = nullptr;
+    else
     {
-        if (pTile->IsOnSlot(mSlot))
-        {
-            return pTile.get();
-        }
+        pMovedOrb_ = lOrbList_[uiMovedOrb].get();
+        mInitialSlot_ = mGame_.GetInitialSlot();
     }
+}
+
+void Board::AddTile_(const Slot& mSlot, Tile::Type mType)
+{
+    lTileList_.push_back(std::unique_ptr<Tile>(new Tile(mSlot, mType)));
+    lSlotTileList_[BitBoard::GetIndex(mSlot)] = lTileList_.back().get();
+}
+
+Tile* Board::GetTile_(const Slot& mSlot)
+{
+    if (mSlot.X() < 0 || mSlot.X() >= BitBoard::WIDTH || mSlot.Y() < 0 || mSlot.Y() >= BitBoard::WIDTH)
+        return nullptr;
 
-    return nullptr;
+    return lSlotTileList_[BitBoard::GetIndex(mSlot)];
+}
+
+Orb* Board::GetOrb_(const Slot& mSlot)
+{
+    Tile* pTile = GetTile_(mSlot);
+    if (!pTile)
+        return nullptr;
+
+    return pTile->GetOrb();
+}
+
+Slot Board::GetSlotAt_(const Vector2D& mPos) const
+{
+    Vector2D mNormalized = (mPos - mPosition_ + Vector2D(32, 32))/64.0f;
+    return Slot(int(std::floor(mNormalized.X())), int(std::floor(mNormalized.Y())));
 }
@@ -0,0 +1,75 @@
+#include "computerplayer.h"
+
+#include <algorithm>
+#include <thread>
+
+ComputerPlayer::ComputerPlayer()
+{
+    bStop_ = false;
+    bStopRequested_ = false;
+    uiThreadCount_ = std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+ComputerPlayer::~ComputerPlayer()
+{
+}
+
+void ComputerPlayer::SetTimeBudget(float fTimeBudget)
+{
+    fTimeBudget_ = fTimeBudget;
+}
+
+float ComputerPlayer::GetTimeBudget() const
+{
+    return fTimeBudget_;
+}
+
+void ComputerPlayer::SetThreadCount(uint_t uiThreadCount)
+{
+    uiThreadCount_ = std::max(uiThreadCount, uint_t(1));
+}
+
+uint_t ComputerPlayer::GetThreadCount() const
+{
+    return uiThreadCount_;
+}
+
+void ComputerPlayer::Stop()
+{
+    bStopRequested_ = true;
+    bStop_ = true;
+}
+
+void ComputerPlayer::ClearStop()
+{
+    bStopRequested_ = false;
+}
+
+const SearchInfo& ComputerPlayer::GetLastSearchInfo() const
+{
+    return mLastInfo_;
+}
+
+void ComputerPlayer::StartSearch_()
+{
+    // Stop() sets bStopRequested_ first : a stop sent at any time is kept
+    bStop_ = false;
+    if (bStopRequested_)
+        bStop_ = true;
+
+    mStartTime_ = std::chrono::steady_clock::now();
+    mLastInfo_ = SearchInfo();
+}
+
+void ComputerPlayer::EndSearch_()
+{
+    mLastInfo_.uiThreadCount = uiThreadCount_;
+    mLastInfo_.fTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - mStartTime_).count();
+    if (mLastInfo_.fTime > 0.0f)
+        mLastInfo_.fNodesPerSecond = mLastInfo_.uiNodes/mLastInfo_.fTime;
+}
+
+bool ComputerPlayer::IsTimeOut_() const
+{
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - mStartTime_).count() > fTimeBudget_;
+}
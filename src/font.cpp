@@ -1,4 +1,5 @@
 #include "font.h"
+#include "fontmanager.h"
 #include "log.h"
 
 #include <ft2build.h>
@@ -7,193 +8,503 @@
 
 #include <SFML/Graphics.hpp>
 
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
 const std::string Font::CLASS_NAME = "Font";
 
-Font::Font( const std::string& sFontFile, const uint_t& uiSize )
+namespace
 {
-    // NOTE : code inspired from Ogre::Font, from the OGRE3D graphics engine
-    // http://www.ogre3d.org
+    const char     CACHE_MAGIC[4] = {'O', 'R', 'B', 'F'};
+    const uint32_t CACHE_VERSION = 2;
+
+    uint64_t GetKerningKey(uint_t uiChar1, uint_t uiChar2)
+    {
+        return (uint64_t(uiChar1) << 32) | uint64_t(uiChar2);
+    }
+
+    /// Reads values one after the other from a memory buffer.
+    class CacheReader
+    {
+    public :
+
+        CacheReader(const uchar_t* pData, uint_t uiSize) : pData_(pData), pEnd_(pData + uiSize)
+        {
+        }
+
+        template<typename T>
+        bool Read(T& mValue)
+        {
+            if (uint_t(pEnd_ - pData_) < sizeof(T))
+                return false;
+
+            std::memcpy(&mValue, pData_, sizeof(T));
+            pData_ += sizeof(T);
+            return true;
+        }
+
+        bool Read(std::string& sValue, uint_t uiSize)
+        {
+            if (uint_t(pEnd_ - pData_) < uiSize)
+                return false;
+
+            sValue.assign(reinterpret_cast<const char*>(pData_), uiSize);
+            pData_ += uiSize;
+            return true;
+        }
 
-    FT_Library mFT;
-    if (FT_Init_FreeType(&mFT))
-        throw std::runtime_error(CLASS_NAME+" : Error initializing FreeType !");
+        const uchar_t* GetPosition() const
+        {
+            return pData_;
+        }
 
-    FT_Face mFace;
+        uint_t GetRemaining() const
+        {
+            return pEnd_ - pData_;
+        }
+
+    private :
+
+        const uchar_t* pData_;
+        const uchar_t* pEnd_;
+    };
+
+    template<typename T>
+    void Write(std::ofstream& mFile, const T& mValue)
+    {
+        mFile.write(reinterpret_cast<const char*>(&mValue), sizeof(T));
+    }
+}
 
+Font::Font( const std::string& sFontFile, const uint_t& uiSize ) :
+    sFontFile_(sFontFile), uiSize_(uiSize)
+{
     // Add some space between letters to prevent artifacts
-    uint_t uiSpacing = 5;
+    uiSpacing_ = 5;
+}
 
-    if (FT_New_Face( mFT, sFontFile.c_str(), 0, &mFace))
+Font::~Font()
+{
+    if (mFace_)
+        FT_Done_Face(mFace_);
+}
+
+void Font::OpenFace_() const
+{
+    // NOTE : code inspired from Ogre::Font, from the OGRE3D graphics engine
+    // http://www.ogre3d.org
+
+    if (mFace_)
+        return;
+
+    FT_Library mLibrary = FontManager::GetSingleton()->GetLibrary();
+
+    if (FT_New_Face(mLibrary, sFontFile_.c_str(), 0, &mFace_))
     {
-        throw std::runtime_error(CLASS_NAME+" : Error loading font : \""+sFontFile+"\".\n"
+        mFace_ = nullptr;
+        throw std::runtime_error(CLASS_NAME+" : Error loading font : \""+sFontFile_+"\".\n"
             "Couldn't load face."
         );
     }
 
-    if (FT_Set_Pixel_Sizes(mFace, uiSize, 0))
+    if (FT_Set_Pixel_Sizes(mFace_, uiSize_, 0))
     {
-        throw std::runtime_error(CLASS_NAME+" : Error loading font : \""+sFontFile+"\".\n"
+        FT_Done_Face(mFace_);
+        mFace_ = nullptr;
+        throw std::runtime_error(CLASS_NAME+" : Error loading font : \""+sFontFile_+"\".\n"
             "Couldn't set font size."
         );
     }
 
-    int iMaxHeight = 0, iMaxWidth = 0, iMaxBearingY = 0;
+    // All characters share the same cell height, so that they line up
+    iAscender_ = mFace_->size->metrics.ascender >> 6;
+    uiLineHeight_ = uint_t((mFace_->size->metrics.ascender - mFace_->size->metrics.descender) >> 6);
 
-    // Calculate maximum width, height and bearing
-    for (uint_t cp = 33; cp <= 255; ++cp)
+    if (uiTextureWidth_ == 0)
     {
-        FT_Load_Char(mFace, cp, FT_LOAD_RENDER);
-
-        int iCharHeight = 2*(mFace->glyph->bitmap.rows << 6) - mFace->glyph->metrics.horiBearingY;
-        if (iCharHeight > iMaxHeight)
-            iMaxHeight = iCharHeight;
-
-        if (mFace->glyph->metrics.horiBearingY > iMaxBearingY)
-            iMaxBearingY = mFace->glyph->metrics.horiBearingY;
+        // Start with room for about one line of text, the texture grows when full
+        uint_t uiWidth = 128;
+        while (uiWidth < 16*(uiSize_ + uiSpacing_))
+            uiWidth *= 2;
+        uiWidth = std::min(uiWidth, uint_t(sf::Texture::getMaximumSize()));
+
+        uint_t uiHeight = 32;
+        while (uiHeight < 2*(uiLineHeight_ + uiSpacing_))
+            uiHeight *= 2;
+
+        mImage_.create(uiWidth, uiHeight, sf::Color(255, 255, 255, 0));
+        uiTextureWidth_ = uiWidth;
+        uiTextureHeight_ = uiHeight;
+    }
+}
 
-        int iCharWidth = (mFace->glyph->advance.x >> 6) + (mFace->glyph->metrics.horiBearingX >> 6);
-        if (iCharWidth > iMaxWidth)
-            iMaxWidth = iCharWidth;
+CharacterInfo& Font::GetCharacter_( uint_t uiChar ) const
+{
+    CharacterInfo& mCI = uiChar < TABLE_SIZE ? lCharacterTable_[uiChar] : lExtraCharacterList_[uiChar];
+    if (!mCI.bLoaded)
+    {
+        mCI.bLoaded = true;
+        RenderCharacter_(uiChar, mCI);
     }
 
-    iMaxBearingY = iMaxBearingY >> 6;
+    return mCI;
+}
 
-    // Calculate the size of the texture
-    std::size_t uiTexSize = (iMaxWidth + uiSpacing)*((iMaxHeight >> 6) + uiSpacing)*(255-33);
+void Font::RenderCharacter_( uint_t uiChar, CharacterInfo& mCI ) const
+{
+    OpenFace_();
 
-    uint_t uiTexSide = static_cast<uint_t>(::sqrt(uiTexSize));
-    uiTexSide += std::max(iMaxWidth, iMaxHeight>>6);
+    // The cached pixels are about to change : take a copy
+    if (mCache_.IsOpen())
+    {
+        mImage_.create(uiTextureWidth_, uiTextureHeight_, mCache_.GetData() + mCache_.GetSize() - 4*uiTextureWidth_*uiTextureHeight_);
+        mCache_.Close();
+    }
 
-    // Round up to nearest power of two
-    uint_t i = 1;
-    while (uiTexSide > i)
-        i += i;
-    uiTexSide = i;
+    bModified_ = true;
 
-    std::size_t uiFinalWidth, uiFinalHeight;
-    if (uiTexSide*uiTexSide/2 >= uiTexSize)
+    if (FT_Load_Char(mFace_, uiChar, FT_LOAD_RENDER))
     {
-        uiFinalHeight = uiTexSide/2;
+        Warning(CLASS_NAME, "Can't load character ", uiChar, " in font \""+sFontFile_+"\".");
+        return;
     }
-    else
+
+    const FT_Bitmap& mBitmap = mFace_->glyph->bitmap;
+    uint_t uiAdvance = std::max(0, int(mFace_->glyph->advance.x >> 6));
+
+    // The glyph is drawn at the left of its cell, which is as wide as the advance
+    uint_t uiCellWidth = std::max(uiAdvance, uint_t(mBitmap.width));
+
+    uint_t uiX, uiY;
+    if (!Reserve_(uiCellWidth, uiLineHeight_, uiX, uiY))
     {
-        uiFinalHeight = uiTexSide;
+        Warning(CLASS_NAME, "No more room to render character ", uiChar, " in font \""+sFontFile_+"\".");
+        return;
     }
-    uiFinalWidth = uiTexSide;
 
-    fTextureWidth_ = static_cast<float>(uiFinalWidth);
-    fTextureHeight_ = static_cast<float>(uiFinalHeight);
+    mCI.mRect = sf::IntRect(uiX, uiY, uiAdvance, uiLineHeight_);
 
-    sf::Image mImage;
-    mImage.create(uiFinalWidth, uiFinalHeight, sf::Color(255, 255, 255, 0));
+    const uchar_t* sBuffer = mBitmap.buffer;
+    if (!sBuffer)
+        return;
 
-    std::size_t l = 0, m = 0;
-    CharacterInfo mCI;
-    for (uint_t cp = 33; cp <= 255; ++cp)
-    {
-        mCI.uiCodePoint = cp;
+    int iYBearing = iAscender_ - mFace_->glyph->bitmap_top;
 
-        if (FT_Load_Char(mFace, cp, FT_LOAD_RENDER))
-        {
-            Warning(CLASS_NAME, "Can't load character ", uchar_t(uint_t(cp)), " in font \""+sFontFile+"\".");
+    for (int j = 0; j < int(mBitmap.rows); ++j)
+    {
+        int iY = j + iYBearing;
+        if (iY < 0 || iY >= int(uiLineHeight_))
             continue;
-        }
 
-        FT_Int iAdvance = (mFace->glyph->advance.x >> 6) + (mFace->glyph->metrics.horiBearingX >> 6);
+        const uchar_t* sRow = sBuffer + j*mBitmap.pitch;
+        for (int k = 0; k < int(mBitmap.width); ++k)
+            mImage_.setPixel(uiX + k, uiY + iY, sf::Color(255, 255, 255, sRow[k]));
+    }
 
-        uchar_t* sBuffer = mFace->glyph->bitmap.buffer;
+    bTextureDirty_ = true;
+}
 
-        if (!sBuffer)
-            continue;
+bool Font::Reserve_( uint_t uiWidth, uint_t uiHeight, uint_t& uiX, uint_t& uiY ) const
+{
+    if (uiWidth > uiTextureWidth_)
+        return false;
 
-        int iYBearing = iMaxBearingY - (mFace->glyph->metrics.horiBearingY >> 6);
+    // Start a new row
+    if (uiPenX_ + uiWidth > uiTextureWidth_)
+    {
+        uiPenX_ = 0;
+        uiPenY_ += uiRowHeight_ + uiSpacing_;
+        uiRowHeight_ = 0;
+    }
 
-        for (int j = 0; j < int(mFace->glyph->bitmap.rows); ++j)
-        {
-            for (int k = 0; k < int(mFace->glyph->bitmap.width); ++k, ++sBuffer)
-            {
-                mImage.setPixel(l + k, j + m + iYBearing, sf::Color(255, 255, 255, *sBuffer));
-            }
-        }
+    // Grow the texture downward, so that rendered characters keep their position
+    if (uiPenY_ + uiHeight > uiTextureHeight_)
+    {
+        uint_t uiImageHeight = uiTextureHeight_;
+        while (uiPenY_ + uiHeight > uiImageHeight)
+            uiImageHeight *= 2;
 
-        /*if (FT_HAS_KERNING(mFace))
-        {
-            FT_Vector kern;
-            unsigned int prev, next;
-            for (uint_t cp2 = 33; cp2 <= 255; ++cp2)
-            {
-                prev = FT_Get_Char_Index(mFace, cp);
-                next = FT_Get_Char_Index(mFace, cp2);
-                if (!FT_Get_Kerning(mFace, prev, next, FT_KERNING_DEFAULT, &kern))
-                {
-                    mCI.lKerningInfo[cp2] = Point<float>(
-                        (kern.x >> 6),
-                        (kern.y >> 6)
-                    );
-                }
-            }
-        }*/
-
-        mCI.fU1 = l/static_cast<float>(uiFinalWidth);
-        mCI.fV1 = m/static_cast<float>(uiFinalHeight);
-        mCI.fU2 = (l + (mFace->glyph->advance.x >> 6))/static_cast<float>(uiFinalWidth);
-        mCI.fV2 = (m + (iMaxHeight >> 6))/static_cast<float>(uiFinalHeight);
-
-        lCharacterList_[cp] = mCI;
-
-        // Advance a column
-        l += (iAdvance + uiSpacing);
-
-        // If at end of row
-        if (l + iAdvance > uiFinalWidth - 1)
-        {
-            m += (iMaxHeight >> 6) + uiSpacing;
-            l = 0;
-        }
+        if (uiImageHeight > sf::Texture::getMaximumSize())
+            return false;
+
+        sf::Image mOldImage = mImage_;
+        mImage_.create(uiTextureWidth_, uiImageHeight, sf::Color(255, 255, 255, 0));
+        mImage_.copy(mOldImage, 0, 0);
+        uiTextureHeight_ = uiImageHeight;
     }
 
-    FT_Done_FreeType(mFT);
+    uiX = uiPenX_;
+    uiY = uiPenY_;
+
+    uiPenX_ += uiWidth + uiSpacing_;
+    uiRowHeight_ = std::max(uiRowHeight_, uiHeight);
 
-    mTexture_.loadFromImage(mImage);
+    return true;
 }
 
-Font::~Font()
+const sf::IntRect& Font::GetCharacterRect( const uint_t& uiChar ) const
 {
+    return GetCharacter_(uiChar).mRect;
 }
 
-std::array<float,4> Font::GetCharacterUVs( const uchar_t& ucChar ) const
+float Font::GetCharacterWidth( const uint_t& uiChar ) const
 {
-    const CharacterInfo& mChar = lCharacterList_.find(ucChar)->second;
-    std::array<float,4> mArray;
-    mArray[0] = mChar.fU1;
-    mArray[1] = mChar.fV1;
-    mArray[2] = mChar.fU2;
-    mArray[3] = mChar.fV2;
-    return mArray;
+    return GetCharacter_(uiChar).mRect.width;
 }
 
-float Font::GetCharacterWidth( const uchar_t& ucChar ) const
+float Font::GetCharacterKerning( const uint_t& uiChar1, const uint_t& uiChar2 ) const
 {
-    const CharacterInfo& mChar = lCharacterList_.find(ucChar)->second;
-    return (mChar.fU2 - mChar.fU1)*fTextureWidth_;
+    if (uiChar1 < TABLE_SIZE && uiChar2 < TABLE_SIZE)
+    {
+        if (lKerningTable_.empty())
+            lKerningTable_.assign(TABLE_SIZE*TABLE_SIZE, std::numeric_limits<float>::quiet_NaN());
+
+        float& fKerning = lKerningTable_[uiChar1*TABLE_SIZE + uiChar2];
+        if (std::isnan(fKerning))
+            fKerning = LoadKerning_(uiChar1, uiChar2);
+
+        return fKerning;
+    }
+
+    uint64_t uiKey = GetKerningKey(uiChar1, uiChar2);
+    auto iter = lExtraKerningList_.find(uiKey);
+    if (iter == lExtraKerningList_.end())
+        iter = lExtraKerningList_.insert(std::make_pair(uiKey, LoadKerning_(uiChar1, uiChar2))).first;
+
+    return iter->second;
 }
 
-float Font::GetCharacterKerning( const uchar_t& ucChar1, const uchar_t& ucChar2 ) const
+float Font::LoadKerning_( uint_t uiChar1, uint_t uiChar2 ) const
 {
-    return lCharacterList_.find(ucChar1)->second.lKerningInfo.find(ucChar2)->second.X();
+    OpenFace_();
+    bModified_ = true;
+
+    if (!FT_HAS_KERNING(mFace_))
+        return 0.0f;
+
+    FT_Vector mKern;
+    if (FT_Get_Kerning(mFace_, FT_Get_Char_Index(mFace_, uiChar1),
+        FT_Get_Char_Index(mFace_, uiChar2), FT_KERNING_DEFAULT, &mKern))
+        return 0.0f;
+
+    return mKern.x >> 6;
 }
 
 float Font::GetTextureWidth() const
 {
-    return fTextureWidth_;
+    return uiTextureWidth_;
 }
 
 float Font::GetTextureHeight() const
 {
-    return fTextureHeight_;
+    return uiTextureHeight_;
+}
+
+const uchar_t* Font::GetPixels_() const
+{
+    if (mCache_.IsOpen())
+        return mCache_.GetData() + mCache_.GetSize() - 4*uiTextureWidth_*uiTextureHeight_;
+    else
+        return mImage_.getPixelsPtr();
 }
 
 sf::Texture* Font::GetTexture()
 {
+    // Upload the characters rendered since the last call
+    if (bTextureDirty_)
+    {
+        if (mTexture_.getSize() != sf::Vector2u(uiTextureWidth_, uiTextureHeight_))
+            mTexture_.create(uiTextureWidth_, uiTextureHeight_);
+
+        mTexture_.update(GetPixels_());
+
+        bTextureDirty_ = false;
+    }
+
     return &mTexture_;
 }
+
+bool Font::LoadCache( const std::string& sCacheFile, long long iFileTime )
+{
+    if (!mCache_.Open(sCacheFile))
+        return false;
+
+    CacheReader mReader(mCache_.GetData(), mCache_.GetSize());
+
+    char lMagic[4];
+    uint32_t uiVersion, uiSize, uiPathLength;
+    int64_t iTime;
+    std::string sPath;
+    if (!mReader.Read(lMagic) || std::memcmp(lMagic, CACHE_MAGIC, 4) != 0 ||
+        !mReader.Read(uiVersion) || uiVersion != CACHE_VERSION ||
+        !mReader.Read(uiSize) || uiSize != uiSize_ ||
+        !mReader.Read(iTime) || iTime != iFileTime ||
+        !mReader.Read(uiPathLength) || !mReader.Read(sPath, uiPathLength) || sPath != sFontFile_)
+    {
+        mCache_.Close();
+        return false;
+    }
+
+    int32_t iAscender;
+    uint32_t uiLineHeight, uiPenX, uiPenY, uiRowHeight, uiWidth, uiHeight, uiCharCount, uiKerningCount;
+    if (!mReader.Read(iAscender) || !mReader.Read(uiLineHeight) ||
+        !mReader.Read(uiPenX) || !mReader.Read(uiPenY) || !mReader.Read(uiRowHeight) ||
+        !mReader.Read(uiWidth) || !mReader.Read(uiHeight) ||
+        !mReader.Read(uiCharCount) || !mReader.Read(uiKerningCount))
+    {
+        mCache_.Close();
+        Warning(CLASS_NAME, "Font cache \""+sCacheFile+"\" is truncated.");
+        return false;
+    }
+
+    bool bValid = true;
+    std::array<CharacterInfo, TABLE_SIZE> lCharacterTable;
+    std::unordered_map<uint_t, CharacterInfo> lExtraCharacterList;
+    for (uint32_t i = 0; i < uiCharCount; ++i)
+    {
+        uint32_t uiCodePoint;
+        int32_t lRect[4];
+        if (!mReader.Read(uiCodePoint) || !mReader.Read(lRect))
+        {
+            bValid = false;
+            break;
+        }
+
+        CharacterInfo& mCI = uiCodePoint < TABLE_SIZE ? lCharacterTable[uiCodePoint] : lExtraCharacterList[uiCodePoint];
+        mCI.mRect = sf::IntRect(lRect[0], lRect[1], lRect[2], lRect[3]);
+        mCI.bLoaded = true;
+    }
+
+    std::vector<float> lKerningTable;
+    std::unordered_map<uint64_t, float> lExtraKerningList;
+    for (uint32_t i = 0; i < uiKerningCount && bValid; ++i)
+    {
+        uint32_t uiChar1, uiChar2;
+        float fKerning;
+        if (!mReader.Read(uiChar1) || !mReader.Read(uiChar2) || !mReader.Read(fKerning))
+        {
+            bValid = false;
+            break;
+        }
+
+        if (uiChar1 < TABLE_SIZE && uiChar2 < TABLE_SIZE)
+        {
+            if (lKerningTable.empty())
+                lKerningTable.assign(TABLE_SIZE*TABLE_SIZE, std::numeric_limits<float>::quiet_NaN());
+
+            lKerningTable[uiChar1*TABLE_SIZE + uiChar2] = fKerning;
+        }
+        else
+            lExtraKerningList[GetKerningKey(uiChar1, uiChar2)] = fKerning;
+    }
+
+    // The pixels fill the rest of the file
+    if (!bValid || mReader.GetRemaining() != 4*uint_t(uiWidth)*uiHeight)
+    {
+        mCache_.Close();
+        Warning(CLASS_NAME, "Font cache \""+sCacheFile+"\" is corrupted.");
+        return false;
+    }
+
+    lCharacterTable_ = lCharacterTable;
+    lExtraCharacterList_ = std::move(lExtraCharacterList);
+    lKerningTable_ = std::move(lKerningTable);
+    lExtraKerningList_ = std::move(lExtraKerningList);
+    iAscender_ = iAscender;
+    uiLineHeight_ = uiLineHeight;
+    uiPenX_ = uiPenX;
+    uiPenY_ = uiPenY;
+    uiRowHeight_ = uiRowHeight;
+    uiTextureWidth_ = uiWidth;
+    uiTextureHeight_ = uiHeight;
+    bTextureDirty_ = true;
+    bModified_ = false;
+
+    return true;
+}
+
+bool Font::SaveCache( const std::string& sCacheFile, long long iFileTime ) const
+{
+    if (!bModified_ || uiTextureWidth_ == 0)
+        return true;
+
+    std::string sTempFile = sCacheFile + ".tmp";
+    std::ofstream mFile(sTempFile, std::ios::binary);
+    if (!mFile.is_open())
+        return false;
+
+    mFile.write(CACHE_MAGIC, 4);
+    Write(mFile, CACHE_VERSION);
+    Write(mFile, uint32_t(uiSize_));
+    Write(mFile, int64_t(iFileTime));
+    Write(mFile, uint32_t(sFontFile_.size()));
+    mFile.write(sFontFile_.data(), sFontFile_.size());
+
+    uint32_t uiCharCount = lExtraCharacterList_.size();
+    for (auto& mChar : lCharacterTable_)
+    {
+        if (mChar.bLoaded)
+            ++uiCharCount;
+    }
+
+    uint32_t uiKerningCount = lExtraKerningList_.size();
+    for (float fKerning : lKerningTable_)
+    {
+        if (!std::isnan(fKerning))
+            ++uiKerningCount;
+    }
+
+    Write(mFile, int32_t(iAscender_));
+    Write(mFile, uint32_t(uiLineHeight_));
+    Write(mFile, uint32_t(uiPenX_));
+    Write(mFile, uint32_t(uiPenY_));
+    Write(mFile, uint32_t(uiRowHeight_));
+    Write(mFile, uint32_t(uiTextureWidth_));
+    Write(mFile, uint32_t(uiTextureHeight_));
+    Write(mFile, uiCharCount);
+    Write(mFile, uiKerningCount);
+
+    auto mWriteCharacter = [&](uint_t uiCodePoint, const CharacterInfo& mChar) {
+        Write(mFile, uint32_t(uiCodePoint));
+        Write(mFile, int32_t(mChar.mRect.left));
+        Write(mFile, int32_t(mChar.mRect.top));
+        Write(mFile, int32_t(mChar.mRect.width));
+        Write(mFile, int32_t(mChar.mRect.height));
+    };
+
+    for (uint_t i = 0; i < TABLE_SIZE; ++i)
+    {
+        if (lCharacterTable_[i].bLoaded)
+            mWriteCharacter(i, lCharacterTable_[i]);
+    }
+
+    for (auto& mChar : lExtraCharacterList_)
+        mWriteCharacter(mChar.first, mChar.second);
+
+    auto mWriteKerning = [&](uint64_t uiKey, float fKerning) {
+        Write(mFile, uint32_t(uiKey >> 32));
+        Write(mFile, uint32_t(uiKey & 0xFFFFFFFF));
+        Write(mFile, fKerning);
+    };
+
+    for (uint_t i = 0; i < lKerningTable_.size(); ++i)
+    {
+        if (!std::isnan(lKerningTable_[i]))
+            mWriteKerning(GetKerningKey(i / TABLE_SIZE, i % TABLE_SIZE), lKerningTable_[i]);
+    }
+
+    for (auto& mKerning : lExtraKerningList_)
+        mWriteKerning(mKerning.first, mKerning.second);
+
+    mFile.write(reinterpret_cast<const char*>(GetPixels_()), 4*uiTextureWidth_*uiTextureHeight_);
+    mFile.close();
+
+    if (!mFile)
+    {
+        std::remove(sTempFile.c_str());
+        return false;
+    }
+
+    return ReplaceFile(sTempFile, sCacheFile);
+}
@@ -2,7 +2,11 @@
 #include "font.h"
 #include "log.h"
 
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
 const std::string FontManager::CLASS_NAME = "FontManager";
+const std::string FontManager::CACHE_DIRECTORY = "cache";
 
 FontManager::FontManager()
 {
@@ -10,6 +14,34 @@ FontManager::FontManager()
 
 FontManager::~FontManager()
 {
+    if (bCacheEnabled_ && !lFontList_.empty() && MakeDirectory(CACHE_DIRECTORY))
+    {
+        for (auto& mEntry : lFontList_)
+        {
+            if (!mEntry.second.pFont->SaveCache(mEntry.second.sCacheFile, mEntry.second.iFileTime))
+                Warning(CLASS_NAME, "Couldn't write font cache \""+mEntry.second.sCacheFile+"\".");
+        }
+    }
+
+    // Faces must be closed before the library
+    lFontList_.clear();
+
+    if (mLibrary_)
+        FT_Done_FreeType(mLibrary_);
+}
+
+FT_Library FontManager::GetLibrary()
+{
+    if (!mLibrary_)
+    {
+        if (FT_Init_FreeType(&mLibrary_))
+        {
+            mLibrary_ = nullptr;
+            throw std::runtime_error(CLASS_NAME+" : Error initializing FreeType !");
+        }
+    }
+
+    return mLibrary_;
 }
 
 Font* FontManager::GetFont(const std::string& sFontFile, const uint_t& uiSize)
@@ -24,12 +56,24 @@ Font* FontManager::GetFont(const std::string& sFontFile, const uint_t& uiSize)
             return nullptr;
         }
 
-        iter = lFontList_.insert(std::make_pair<std::string, std::unique_ptr<Font>>(
-            std::move(sID), std::unique_ptr<Font>(new Font(sFontFile, uiSize))
-        )).first;
+        FontEntry_ mEntry;
+        mEntry.pFont = std::unique_ptr<Font>(new Font(sFontFile, uiSize));
+        mEntry.iFileTime = GetFileTime(sFontFile);
+        mEntry.sCacheFile = CACHE_DIRECTORY + "/" + Replace(Replace(Replace(sFontFile, "/", "_"), "\\", "_"), ":", "_")
+            + "_" + ToString(uiSize) + ".cache";
+
+        if (bCacheEnabled_ && mEntry.pFont->LoadCache(mEntry.sCacheFile, mEntry.iFileTime))
+            Log("Loaded font \""+sFontFile+"\" (size : "+ToString(uiSize)+") from cache.");
+
+        iter = lFontList_.insert(std::make_pair(std::move(sID), std::move(mEntry))).first;
     }
 
-    return iter->second.get();
+    return iter->second.pFont.get();
+}
+
+void FontManager::SetCacheEnabled(bool bEnabled)
+{
+    bCacheEnabled_ = bEnabled;
 }
 
 const std::string& FontManager::GetDefaultFont() const
@@ -0,0 +1,650 @@
+#include "gameserver.h"
+#include "gamestate.h"
+#include "netsocket.h"
+#include "log.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+const std::string GameServer::CLASS_NAME = "GameServer";
+
+namespace
+{
+    const int MAX_EVENTS = 256;
+    /// Time between two checks of the stop flag (in milliseconds)
+    const int POLL_TIMEOUT = 100;
+
+    bool WatchSocket(int iEpoll, int iOperation, int iSocket, uint32_t uiEvents, void* pData)
+    {
+        epoll_event mEvent;
+        std::memset(&mEvent, 0, sizeof(mEvent));
+        mEvent.events = uiEvents;
+        if (pData)
+            mEvent.data.ptr = pData;
+        else
+            mEvent.data.fd = iSocket;
+
+        return epoll_ctl(iEpoll, iOperation, iSocket, &mEvent) == 0;
+    }
+}
+
+struct GameServer::Connection_
+{
+    int     iSocket = -1;
+    Match_* pMatch = nullptr;
+    uint_t  uiPlayer = 0;
+    uint_t  uiInSize = 0;
+    uint_t  uiOutSize = 0;
+    /// The socket is full, wait for it to accept more data
+    bool    bWaitWrite = false;
+    std::array<uchar_t, IN_BUFFER_SIZE>  lInBuffer;
+    std::array<uchar_t, OUT_BUFFER_SIZE> lOutBuffer;
+};
+
+struct GameServer::Match_
+{
+    GameState mGame;
+    uint_t    uiPly = 0;
+    /// Position in the list of the worker
+    uint_t    uiIndex = 0;
+    bool      bClosed = false;
+    /// Indexed by player
+    std::array<Connection_, 2> lConnectionList;
+};
+
+struct GameServer::Worker_
+{
+    std::thread mThread;
+    int iEpoll = -1;
+    int iWakeEvent = -1;
+
+    /// Matches given by the accepting thread, not yet watched
+    std::mutex mMutex;
+    std::vector< std::unique_ptr<Match_> > lNewMatchList;
+
+    std::vector< std::unique_ptr<Match_> > lMatchList;
+    /// Matches closed while handling events, deleted after
+    std::vector<Match_*> lClosedList;
+
+    std::atomic<uint64_t> uiMoves;
+    std::atomic<uint64_t> uiGames;
+    std::atomic<uint64_t> uiRejected;
+    std::atomic<uint64_t> uiClosed;
+};
+
+GameServer::GameServer(uint_t uiWorkerCount)
+{
+    bStop_ = false;
+
+    for (uint_t i = 0; i < std::max(uiWorkerCount, uint_t(1)); ++i)
+    {
+        lWorkerList_.push_back(std::unique_ptr<Worker_>(new Worker_()));
+        Worker_& mWorker = *lWorkerList_.back();
+        mWorker.uiMoves = 0;
+        mWorker.uiGames = 0;
+        mWorker.uiRejected = 0;
+        mWorker.uiClosed = 0;
+    }
+}
+
+GameServer::~GameServer()
+{
+    Stop();
+
+    for (auto& pWorker : lWorkerList_)
+    {
+        if (pWorker->mThread.joinable())
+            pWorker->mThread.join();
+
+        for (auto& pMatch : pWorker->lMatchList)
+        {
+            for (auto& mConnection : pMatch->lConnectionList)
+                CloseSocket(mConnection.iSocket);
+        }
+
+        for (auto& pMatch : pWorker->lNewMatchList)
+        {
+            for (auto& mConnection : pMatch->lConnectionList)
+                CloseSocket(mConnection.iSocket);
+        }
+
+        CloseSocket(pWorker->iEpoll);
+        CloseSocket(pWorker->iWakeEvent);
+    }
+
+    for (auto& mPending : lPendingList_)
+        CloseSocket(mPending.first);
+
+    CloseSocket(iAcceptEpoll_);
+    CloseSocket(iListenSocket_);
+}
+
+bool GameServer::Start(unsigned short uiPort)
+{
+    iListenSocket_ = OpenListenSocket(uiPort);
+    if (iListenSocket_ < 0)
+    {
+        Error(CLASS_NAME, "Cannot listen to port "+ToString(uiPort)+".");
+        return false;
+    }
+
+    iAcceptEpoll_ = epoll_create1(0);
+    if (iAcceptEpoll_ < 0 || !WatchSocket(iAcceptEpoll_, EPOLL_CTL_ADD, iListenSocket_, EPOLLIN, nullptr))
+    {
+        Error(CLASS_NAME, "Cannot create the event loop.");
+        return false;
+    }
+
+    for (auto& pWorker : lWorkerList_)
+    {
+        Worker_& mWorker = *pWorker;
+        mWorker.iEpoll = epoll_create1(0);
+        mWorker.iWakeEvent = eventfd(0, EFD_NONBLOCK);
+
+        // The wake event is the only one without a connection
+        epoll_event mEvent;
+        std::memset(&mEvent, 0, sizeof(mEvent));
+        mEvent.events = EPOLLIN;
+        mEvent.data.ptr = nullptr;
+
+        if (mWorker.iEpoll < 0 || mWorker.iWakeEvent < 0 ||
+            epoll_ctl(mWorker.iEpoll, EPOLL_CTL_ADD, mWorker.iWakeEvent, &mEvent) != 0)
+        {
+            Error(CLASS_NAME, "Cannot create the event loop of a worker.");
+            return false;
+        }
+    }
+
+    for (auto& pWorker : lWorkerList_)
+    {
+        Worker_* pRunWorker = pWorker.get();
+        pWorker->mThread = std::thread([this, pRunWorker]() { RunWorker_(*pRunWorker); });
+    }
+
+    Log("Listening to port "+ToString(uiPort)+" with "+ToString(lWorkerList_.size())+" workers.");
+    return true;
+}
+
+void GameServer::Stop()
+{
+    bStop_ = true;
+}
+
+GameServer::Statistics GameServer::GetStatistics() const
+{
+    Statistics mStatistics;
+    mStatistics.uiMatches = uiMatches_;
+
+    uint64_t uiClosed = 0;
+    for (auto& pWorker : lWorkerList_)
+    {
+        mStatistics.uiMoves += pWorker->uiMoves;
+        mStatistics.uiGames += pWorker->uiGames;
+        mStatistics.uiRejected += pWorker->uiRejected;
+        uiClosed += pWorker->uiClosed;
+    }
+
+    mStatistics.uiActiveMatches = mStatistics.uiMatches - std::min(uiClosed, mStatistics.uiMatches);
+    return mStatistics;
+}
+
+void GameServer::Run(float fReportPeriod)
+{
+    std::array<epoll_event, MAX_EVENTS> lEventList;
+
+    auto mLastReport = std::chrono::steady_clock::now();
+    uint64_t uiLastMoves = 0;
+
+    while (!bStop_)
+    {
+        int iCount = epoll_wait(iAcceptEpoll_, lEventList.data(), MAX_EVENTS, POLL_TIMEOUT);
+        for (int i = 0; i < iCount; ++i)
+        {
+            int iSocket = lEventList[i].data.fd;
+            if (iSocket == iListenSocket_)
+                AcceptClients_();
+            else
+                ReadPendingClient_(iSocket);
+        }
+
+        auto mNow = std::chrono::steady_clock::now();
+        float fElapsed = std::chrono::duration<float>(mNow - mLastReport).count();
+        if (fReportPeriod > 0.0f && fElapsed >= fReportPeriod)
+        {
+            Statistics mStatistics = GetStatistics();
+            Log(ToString(mStatistics.uiActiveMatches)+" matches, "+
+                ToString(uint64_t((mStatistics.uiMoves - uiLastMoves)/fElapsed))+" moves/s, "+
+                ToString(mStatistics.uiGames)+" games played, "+
+                ToString(mStatistics.uiRejected)+" rejected, "+
+                ToString(lWaitingList_[0].size() + lWaitingList_[1].size())+" clients waiting");
+
+            mLastReport = mNow;
+            uiLastMoves = mStatistics.uiMoves;
+        }
+    }
+
+    for (auto& pWorker : lWorkerList_)
+    {
+        if (pWorker->mThread.joinable())
+            pWorker->mThread.join();
+    }
+}
+
+void GameServer::AcceptClients_()
+{
+    for (;;)
+    {
+        int iSocket = accept(iListenSocket_, nullptr, nullptr);
+        if (iSocket < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                Warning(CLASS_NAME, "Cannot accept a client : "+std::string(std::strerror(errno))+".");
+            return;
+        }
+
+        if (!SetSocketOptions(iSocket) || !WatchSocket(iAcceptEpoll_, EPOLL_CTL_ADD, iSocket, EPOLLIN, nullptr))
+        {
+            CloseSocket(iSocket);
+            continue;
+        }
+
+        lPendingList_[iSocket].iSocket = iSocket;
+    }
+}
+
+void GameServer::ReadPendingClient_(int iSocket)
+{
+    auto iter = lPendingList_.find(iSocket);
+    if (iter == lPendingList_.end())
+        return;
+
+    PendingClient_& mClient = iter->second;
+    for (;;)
+    {
+        ssize_t iSize = recv(iSocket, mClient.lBuffer.data() + mClient.uiSize, IN_BUFFER_SIZE - mClient.uiSize, 0);
+        if (iSize > 0)
+        {
+            mClient.uiSize += iSize;
+            if (mClient.uiSize == IN_BUFFER_SIZE)
+                break;
+        }
+        else if (iSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else if (iSize < 0 && errno == EINTR)
+            continue;
+        else
+        {
+            DropPendingClient_(iSocket);
+            return;
+        }
+    }
+
+    // A client waiting for an opponent must not send anything
+    if (mClient.uiPlayer != npos)
+    {
+        DropPendingClient_(iSocket);
+        return;
+    }
+
+    NetMessage mMessage;
+    uint_t uiSize = NetProtocol::Read(mClient.lBuffer.data(), mClient.uiSize, mMessage);
+    if (uiSize == 0)
+        return;
+
+    if (uiSize == npos || mMessage.mType != NetMessage::TYPE_HELLO || uiSize != mClient.uiSize)
+    {
+        DropPendingClient_(iSocket);
+        return;
+    }
+
+    mClient.uiPlayer = mMessage.uiPlayer;
+    mClient.uiSize = 0;
+
+    std::deque<int>& lOpponentList = lWaitingList_[1 - mClient.uiPlayer];
+    if (lOpponentList.empty())
+        lWaitingList_[mClient.uiPlayer].push_back(iSocket);
+    else
+    {
+        int iOpponent = lOpponentList.front();
+        lOpponentList.pop_front();
+        StartMatch_(iSocket, iOpponent);
+    }
+}
+
+void GameServer::DropPendingClient_(int iSocket)
+{
+    for (auto& lWaiting : lWaitingList_)
+    {
+        auto iter = std::find(lWaiting.begin(), lWaiting.end(), iSocket);
+        if (iter != lWaiting.end())
+            lWaiting.erase(iter);
+    }
+
+    epoll_ctl(iAcceptEpoll_, EPOLL_CTL_DEL, iSocket, nullptr);
+    CloseSocket(iSocket);
+    lPendingList_.erase(iSocket);
+}
+
+void GameServer::StartMatch_(int iSocket1, int iSocket2)
+{
+    std::unique_ptr<Match_> pMatch(new Match_());
+
+    for (int iSocket : {iSocket1, iSocket2})
+    {
+        Connection_& mConnection = pMatch->lConnectionList[lPendingList_[iSocket].uiPlayer];
+        mConnection.iSocket = iSocket;
+        mConnection.uiPlayer = lPendingList_[iSocket].uiPlayer;
+        mConnection.pMatch = pMatch.get();
+
+        // The server speaks for the other player
+        NetMessage mMessage;
+        mMessage.mType = NetMessage::TYPE_HELLO;
+        mMessage.uiPlayer = 1 - mConnection.uiPlayer;
+        mConnection.uiOutSize = NetProtocol::Write(mMessage, mConnection.lOutBuffer.data());
+
+        epoll_ctl(iAcceptEpoll_, EPOLL_CTL_DEL, iSocket, nullptr);
+        lPendingList_.erase(iSocket);
+    }
+
+    ++uiMatches_;
+    Debug(CLASS_NAME, "Match ", uiMatches_, " started on worker ", uiNextWorker_, ".");
+
+    // Spread the matches over the workers
+    Worker_& mWorker = *lWorkerList_[uiNextWorker_];
+    uiNextWorker_ = (uiNextWorker_ + 1) % lWorkerList_.size();
+
+    {
+        std::lock_guard<std::mutex> mLock(mWorker.mMutex);
+        mWorker.lNewMatchList.push_back(std::move(pMatch));
+    }
+
+    uint64_t uiWake = 1;
+    if (write(mWorker.iWakeEvent, &uiWake, sizeof(uiWake)) < 0)
+        Warning(CLASS_NAME, "Cannot wake a worker up.");
+}
+
+void GameServer::RunWorker_(Worker_& mWorker)
+{
+    std::array<epoll_event, MAX_EVENTS> lEventList;
+
+    while (!bStop_)
+    {
+        int iCount = epoll_wait(mWorker.iEpoll, lEventList.data(), MAX_EVENTS, POLL_TIMEOUT);
+        for (int i = 0; i < iCount; ++i)
+        {
+            Connection_* pConnection = static_cast<Connection_*>(lEventList[i].data.ptr);
+            if (!pConnection)
+            {
+                AddNewMatches_(mWorker);
+                continue;
+            }
+
+            // The match may have been closed by a previous event
+            if (pConnection->pMatch->bClosed)
+                continue;
+
+            if (lEventList[i].events & EPOLLOUT)
+                Flush_(mWorker, *pConnection);
+
+            if (!pConnection->pMatch->bClosed && (lEventList[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+                Read_(mWorker, *pConnection);
+        }
+
+        // Delete the closed matches, now that no event points to them
+        for (Match_* pMatch : mWorker.lClosedList)
+        {
+            uint_t uiIndex = pMatch->uiIndex;
+            std::swap(mWorker.lMatchList[uiIndex], mWorker.lMatchList.back());
+            mWorker.lMatchList[uiIndex]->uiIndex = uiIndex;
+            mWorker.lMatchList.pop_back();
+        }
+
+        mWorker.lClosedList.clear();
+    }
+}
+
+void GameServer::AddNewMatches_(Worker_& mWorker)
+{
+    uint64_t uiWake;
+    if (read(mWorker.iWakeEvent, &uiWake, sizeof(uiWake)) < 0 && errno != EAGAIN)
+        return;
+
+    std::vector< std::unique_ptr<Match_> > lNewMatchList;
+    {
+        std::lock_guard<std::mutex> mLock(mWorker.mMutex);
+        std::swap(lNewMatchList, mWorker.lNewMatchList);
+    }
+
+    for (auto& pNewMatch : lNewMatchList)
+    {
+        Match_& mMatch = *pNewMatch;
+        mMatch.uiIndex = mWorker.lMatchList.size();
+        mWorker.lMatchList.push_back(std::move(pNewMatch));
+
+        for (auto& mConnection : mMatch.lConnectionList)
+        {
+            if (!WatchSocket(mWorker.iEpoll, EPOLL_CTL_ADD, mConnection.iSocket, EPOLLIN, &mConnection))
+            {
+                CloseMatch_(mWorker, mMatch);
+                break;
+            }
+        }
+
+        // Send the HELLOs
+        for (auto& mConnection : mMatch.lConnectionList)
+        {
+            if (mMatch.bClosed || !Flush_(mWorker, mConnection))
+                break;
+        }
+    }
+}
+
+void GameServer::Read_(Worker_& mWorker, Connection_& mConnection)
+{
+    Match_& mMatch = *mConnection.pMatch;
+
+    for (;;)
+    {
+        uint_t uiSpace = IN_BUFFER_SIZE - mConnection.uiInSize;
+        ssize_t iSize = recv(mConnection.iSocket, mConnection.lInBuffer.data() + mConnection.uiInSize, uiSpace, 0);
+
+        if (iSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+        else if (iSize < 0 && errno == EINTR)
+            continue;
+        else if (iSize <= 0)
+        {
+            // The client left without a word : tell the other one
+            NetMessage mMessage;
+            mMessage.mType = NetMessage::TYPE_BYE;
+            Send_(mWorker, mMatch.lConnectionList[1 - mConnection.uiPlayer], mMessage);
+            CloseMatch_(mWorker, mMatch);
+            return;
+        }
+
+        mConnection.uiInSize += iSize;
+
+        // Play all the complete messages, keep the rest for later
+        uint_t uiOffset = 0;
+        for (;;)
+        {
+            NetMessage mMessage;
+            uint_t uiMessageSize = NetProtocol::Read(mConnection.lInBuffer.data() + uiOffset,
+                mConnection.uiInSize - uiOffset, mMessage);
+
+            if (uiMessageSize == 0)
+                break;
+
+            if (uiMessageSize == npos)
+            {
+                Reject_(mWorker, mMatch);
+                return;
+            }
+
+            uiOffset += uiMessageSize;
+
+            if (!Play_(mWorker, mConnection, mMessage))
+                return;
+        }
+
+        std::memmove(mConnection.lInBuffer.data(), mConnection.lInBuffer.data() + uiOffset, mConnection.uiInSize - uiOffset);
+        mConnection.uiInSize -= uiOffset;
+    }
+}
+
+bool GameServer::Play_(Worker_& mWorker, Connection_& mConnection, const NetMessage& mMessage)
+{
+    Match_& mMatch = *mConnection.pMatch;
+    GameState& mGame = mMatch.mGame;
+
+    switch (mMessage.mType)
+    {
+        case NetMessage::TYPE_MOVE :
+        {
+            // Same checks as a game receiving a turn (see Board)
+            const Move& mMove = mMessage.mMove;
+            if (mConnection.uiPlayer != mGame.GetPlayer() || mMessage.uiPly != (mMatch.uiPly & 0xFFFF))
+            {
+                Reject_(mWorker, mMatch);
+                return false;
+            }
+
+            if (mMove == Move())
+                mGame.EndTurn();
+            else
+            {
+                uint_t uiOrb = mGame.GetOrbAt(uint_t(mMove.uiFrom));
+                if (uiOrb == npos || !mGame.CanPlay(uiOrb) || !mGame.GetMovements(uiOrb).Test(mMove.uiTo))
+                {
+                    Reject_(mWorker, mMatch);
+                    return false;
+                }
+
+                mGame.PlayMove(mMove);
+            }
+
+            Trace(CLASS_NAME, "Player ", mConnection.uiPlayer + 1, " played ", uint_t(mMove.uiFrom),
+                " -> ", uint_t(mMove.uiTo), " at ply ", mMatch.uiPly, ".");
+
+            ++mMatch.uiPly;
+            mWorker.uiMoves.fetch_add(1, std::memory_order_relaxed);
+
+            if (mGame.IsOver())
+            {
+                Debug(CLASS_NAME, "Player ", mConnection.uiPlayer + 1, " won in ", mMatch.uiPly, " plies.");
+                mGame.Reset();
+                mMatch.uiPly = 0;
+                mWorker.uiGames.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return Send_(mWorker, mMatch.lConnectionList[1 - mConnection.uiPlayer], mMessage);
+        }
+        case NetMessage::TYPE_BYE :
+            Send_(mWorker, mMatch.lConnectionList[1 - mConnection.uiPlayer], mMessage);
+            CloseMatch_(mWorker, mMatch);
+            return false;
+        case NetMessage::TYPE_HELLO :
+            break;
+    }
+
+    Reject_(mWorker, mMatch);
+    return false;
+}
+
+bool GameServer::Send_(Worker_& mWorker, Connection_& mConnection, const NetMessage& mMessage)
+{
+    // A client that doesn't read what it is sent cannot play
+    if (mConnection.uiOutSize + NetProtocol::MAX_MESSAGE_SIZE > OUT_BUFFER_SIZE)
+    {
+        CloseMatch_(mWorker, *mConnection.pMatch);
+        return false;
+    }
+
+    mConnection.uiOutSize += NetProtocol::Write(mMessage, mConnection.lOutBuffer.data() + mConnection.uiOutSize);
+    return Flush_(mWorker, mConnection);
+}
+
+bool GameServer::Flush_(Worker_& mWorker, Connection_& mConnection)
+{
+    while (mConnection.uiOutSize != 0)
+    {
+        ssize_t iSize = send(mConnection.iSocket, mConnection.lOutBuffer.data(), mConnection.uiOutSize, MSG_NOSIGNAL);
+        if (iSize > 0)
+        {
+            std::memmove(mConnection.lOutBuffer.data(), mConnection.lOutBuffer.data() + iSize, mConnection.uiOutSize - iSize);
+            mConnection.uiOutSize -= iSize;
+        }
+        else if (iSize < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            if (!mConnection.bWaitWrite)
+            {
+                WatchSocket(mWorker.iEpoll, EPOLL_CTL_MOD, mConnection.iSocket, EPOLLIN | EPOLLOUT, &mConnection);
+                mConnection.bWaitWrite = true;
+            }
+            return true;
+        }
+        else if (iSize < 0 && errno == EINTR)
+            continue;
+        else
+        {
+            CloseMatch_(mWorker, *mConnection.pMatch);
+            return false;
+        }
+    }
+
+    if (mConnection.bWaitWrite)
+    {
+        WatchSocket(mWorker.iEpoll, EPOLL_CTL_MOD, mConnection.iSocket, EPOLLIN, &mConnection);
+        mConnection.bWaitWrite = false;
+    }
+
+    return true;
+}
+
+void GameServer::Reject_(Worker_& mWorker, Match_& mMatch)
+{
+    if (mMatch.bClosed)
+        return;
+
+    mWorker.uiRejected.fetch_add(1, std::memory_order_relaxed);
+    Debug(CLASS_NAME, "Match rejected at ply ", mMatch.uiPly, " : invalid message or turn.");
+
+    // Best effort : both clients learn that the match is over
+    NetMessage mMessage;
+    mMessage.mType = NetMessage::TYPE_BYE;
+    for (auto& mConnection : mMatch.lConnectionList)
+    {
+        if (mMatch.bClosed)
+            break;
+
+        Send_(mWorker, mConnection, mMessage);
+    }
+
+    CloseMatch_(mWorker, mMatch);
+}
+
+void GameServer::CloseMatch_(Worker_& mWorker, Match_& mMatch)
+{
+    if (mMatch.bClosed)
+        return;
+
+    mMatch.bClosed = true;
+
+    for (auto& mConnection : mMatch.lConnectionList)
+    {
+        epoll_ctl(mWorker.iEpoll, EPOLL_CTL_DEL, mConnection.iSocket, nullptr);
+        CloseSocket(mConnection.iSocket);
+        mConnection.iSocket = -1;
+    }
+
+    mWorker.lClosedList.push_back(&mMatch);
+    mWorker.uiClosed.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,342 @@
+#include "gamestate.h"
+#include "movegenerator.h"
+#include "zobrist.h"
+
+const uchar_t GameState::NO_ORB;
+
+GameState::GameState()
+{
+    Reset();
+}
+
+void GameState::Reset()
+{
+    mState_ = STATE_PLAYER1;
+    uiHash_ = 0;
+    mOccupied_ = BitBoard();
+    lColorMaskList_.fill(BitBoard());
+    lSlotOrbList_.fill(NO_ORB);
+    uiOrbCount_ = 0;
+    uiMovedOrb_ = npos;
+
+    for (int i = 2; i < 8; ++i)
+    {
+        for (int j = 0; j < 2; ++j)
+            AddOrb_(Slot(i, j), BLUE);
+
+        for (int j = 8; j < 10; ++j)
+            AddOrb_(Slot(i, j), RED);
+    }
+
+    for (int j = 2; j < 8; ++j)
+    {
+        for (int i = 0; i < 2; ++i)
+            AddOrb_(Slot(i, j), GREEN);
+
+        for (int i = 8; i < 10; ++i)
+            AddOrb_(Slot(i, j), PINK);
+    }
+}
+
+bool GameState::SetLayout(const std::array<uchar_t, ORB_COUNT>& lOrbSlotList, State mState,
+    uint_t uiMovedOrb, uint_t uiInitialSlot)
+{
+    // Colors are given by the initial layout
+    Reset();
+    std::array<uchar_t, ORB_COUNT> lOrbColorList = lOrbColorList_;
+
+    mState_ = STATE_PLAYER1;
+    uiHash_ = 0;
+    mOccupied_ = BitBoard();
+    lColorMaskList_.fill(BitBoard());
+    lSlotOrbList_.fill(NO_ORB);
+    uiOrbCount_ = 0;
+
+    const BitBoard& mBoard = MoveGenerator::GetBoardMask();
+    for (uint_t i = 0; i < ORB_COUNT; ++i)
+    {
+        uint_t uiIndex = lOrbSlotList[i];
+        if (uiIndex >= BitBoard::SIZE || !mBoard.Test(uiIndex) || mOccupied_.Test(uiIndex))
+        {
+            Reset();
+            return false;
+        }
+
+        AddOrb_(BitBoard::GetSlot(uiIndex), (Color)lOrbColorList[i]);
+    }
+
+    if (mState > STATE_VICTORY2)
+    {
+        Reset();
+        return false;
+    }
+
+    SetState_(mState);
+
+    if (uiMovedOrb != npos)
+    {
+        // The moved orb must belong to the current player, and must
+        // have been able to reach its slot from its initial slot
+        if (uiMovedOrb >= ORB_COUNT || IsOver() || !CanPlay(uiMovedOrb) ||
+            uiInitialSlot >= BitBoard::SIZE || !mBoard.Test(uiInitialSlot) || mOccupied_.Test(uiInitialSlot))
+        {
+            Reset();
+            return false;
+        }
+
+        uint_t uiIndex = lOrbSlotList_[uiMovedOrb];
+        BitBoard mOccupied = mOccupied_;
+        mOccupied.Reset(uiIndex);
+        mOccupied.Set(uiInitialSlot);
+
+        if (!MoveGenerator::GetMovements(mOccupied, uiInitialSlot).Test(uiIndex))
+        {
+            Reset();
+            return false;
+        }
+
+        uiMovedOrb_ = uiMovedOrb;
+        uiInitialSlot_ = uiInitialSlot;
+    }
+
+    return true;
+}
+
+void GameState::AddOrb_(const Slot& mSlot, Color mColor)
+{
+    uint_t uiIndex = BitBoard::GetIndex(mSlot);
+
+    lOrbSlotList_[uiOrbCount_] = uiIndex;
+    lOrbColorList_[uiOrbCount_] = mColor;
+    lSlotOrbList_[uiIndex] = uiOrbCount_;
+    mOccupied_.Set(uiIndex);
+    lColorMaskList_[mColor].Set(uiIndex);
+    uiHash_ ^= Zobrist::GetOrbKey(mColor, uiIndex);
+
+    ++uiOrbCount_;
+}
+
+GameState::State GameState::GetState() const
+{
+    return mState_;
+}
+
+bool GameState::IsOver() const
+{
+    return mState_ == STATE_VICTORY1 || mState_ == STATE_VICTORY2;
+}
+
+uint_t GameState::GetPlayer() const
+{
+    return mState_ == STATE_PLAYER2 ? 1 : 0;
+}
+
+uint64_t GameState::GetHash() const
+{
+    return uiHash_;
+}
+
+uint_t GameState::GetOrbAt(const Slot& mSlot) const
+{
+    if (!MoveGenerator::IsOnBoard(mSlot))
+        return npos;
+
+    return GetOrbAt(BitBoard::GetIndex(mSlot));
+}
+
+uint_t GameState::GetOrbAt(uint_t uiIndex) const
+{
+    uchar_t uiOrb = lSlotOrbList_[uiIndex];
+    return uiOrb == NO_ORB ? npos : uiOrb;
+}
+
+Slot GameState::GetOrbSlot(uint_t uiOrb) const
+{
+    return BitBoard::GetSlot(lOrbSlotList_[uiOrb]);
+}
+
+uint_t GameState::GetOrbIndex(uint_t uiOrb) const
+{
+    return lOrbSlotList_[uiOrb];
+}
+
+GameState::Color GameState::GetOrbColor(uint_t uiOrb) const
+{
+    return (Color)lOrbColorList_[uiOrb];
+}
+
+bool GameState::IsWellPlaced(uint_t uiOrb) const
+{
+    return MoveGenerator::GetHomeMask(lOrbColorList_[uiOrb]).Test(lOrbSlotList_[uiOrb]);
+}
+
+const BitBoard& GameState::GetOccupied() const
+{
+    return mOccupied_;
+}
+
+const BitBoard& GameState::GetColorMask(Color mColor) const
+{
+    return lColorMaskList_[mColor];
+}
+
+BitBoard GameState::GetPlayerMask(uint_t uiPlayer) const
+{
+    if (uiPlayer == 0)
+        return lColorMaskList_[RED] | lColorMaskList_[BLUE];
+    else
+        return lColorMaskList_[GREEN] | lColorMaskList_[PINK];
+}
+
+bool GameState::CanPlay(uint_t uiOrb) const
+{
+    if (IsOver())
+        return false;
+
+    if (uiMovedOrb_ != npos && uiMovedOrb_ != uiOrb)
+        return false;
+
+    return GetPlayerMask(GetPlayer()).Test(lOrbSlotList_[uiOrb]);
+}
+
+BitBoard GameState::GetMovements(uint_t uiOrb) const
+{
+    uint_t uiIndex = lOrbSlotList_[uiOrb];
+    if (uiOrb != uiMovedOrb_)
+        return MoveGenerator::GetMovements(mOccupied_, uiIndex);
+
+    // The moved orb can still go anywhere it could reach at the beginning of the turn
+    BitBoard mOccupied = mOccupied_;
+    mOccupied.Reset(uiIndex);
+    mOccupied.Set(uiInitialSlot_);
+
+    BitBoard mMovements = MoveGenerator::GetMovements(mOccupied, uiInitialSlot_);
+    mMovements.Reset(uiIndex);
+    mMovements.Set(uiInitialSlot_);
+    return mMovements;
+}
+
+bool GameState::MoveOrb(uint_t uiOrb, const Slot& mSlot)
+{
+    if (!CanPlay(uiOrb) || !MoveGenerator::IsOnBoard(mSlot))
+        return false;
+
+    uint_t uiTo = BitBoard::GetIndex(mSlot);
+    if (mOccupied_.Test(uiTo) || !GetMovements(uiOrb).Test(uiTo))
+        return false;
+
+    if (uiMovedOrb_ == npos)
+        uiInitialSlot_ = lOrbSlotList_[uiOrb];
+
+    MoveOrb_(uiOrb, uiTo);
+
+    if (uiTo == uiInitialSlot_)
+        uiMovedOrb_ = npos;
+    else
+        uiMovedOrb_ = uiOrb;
+
+    UpdateVictory_();
+
+    return true;
+}
+
+void GameState::CancelMove()
+{
+    if (uiMovedOrb_ == npos)
+        return;
+
+    MoveOrb_(uiMovedOrb_, uiInitialSlot_);
+    uiMovedOrb_ = npos;
+}
+
+uint_t GameState::GetMovedOrb() const
+{
+    return uiMovedOrb_;
+}
+
+Slot GameState::GetInitialSlot() const
+{
+    return BitBoard::GetSlot(uiInitialSlot_);
+}
+
+void GameState::EndTurn()
+{
+    if (IsOver())
+        return;
+
+    uiMovedOrb_ = npos;
+    SetState_(mState_ == STATE_PLAYER1 ? STATE_PLAYER2 : STATE_PLAYER1);
+}
+
+void GameState::GenerateMoves(std::vector<Move>& lMoveList) const
+{
+    lMoveList.clear();
+
+    if (IsOver())
+        return;
+
+    BitBoard mOrbs = GetPlayerMask(GetPlayer());
+    while (!mOrbs.IsEmpty())
+    {
+        uint_t uiFrom = mOrbs.PopFirst();
+        BitBoard mMovements = MoveGenerator::GetMovements(mOccupied_, uiFrom);
+        while (!mMovements.IsEmpty())
+            lMoveList.push_back(Move(uiFrom, mMovements.PopFirst()));
+    }
+}
+
+void GameState::PlayMove(const Move& mMove)
+{
+    MoveOrb_(lSlotOrbList_[mMove.uiFrom], mMove.uiTo);
+    UpdateVictory_();
+
+    if (!IsOver())
+        SetState_(mState_ == STATE_PLAYER1 ? STATE_PLAYER2 : STATE_PLAYER1);
+}
+
+void GameState::UndoMove(const Move& mMove)
+{
+    uint_t uiOrb = lSlotOrbList_[mMove.uiTo];
+    MoveOrb_(uiOrb, mMove.uiFrom);
+
+    Color mColor = (Color)lOrbColorList_[uiOrb];
+    SetState_((mColor == RED || mColor == BLUE) ? STATE_PLAYER1 : STATE_PLAYER2);
+}
+
+void GameState::MoveOrb_(uint_t uiOrb, uint_t uiTo)
+{
+    uint_t uiFrom = lOrbSlotList_[uiOrb];
+    uchar_t uiColor = lOrbColorList_[uiOrb];
+
+    lSlotOrbList_[uiFrom] = NO_ORB;
+    lSlotOrbList_[uiTo] = uiOrb;
+    lOrbSlotList_[uiOrb] = uiTo;
+
+    mOccupied_.Reset(uiFrom);
+    mOccupied_.Set(uiTo);
+    lColorMaskList_[uiColor].Reset(uiFrom);
+    lColorMaskList_[uiColor].Set(uiTo);
+
+    uiHash_ ^= Zobrist::GetOrbKey(uiColor, uiFrom) ^ Zobrist::GetOrbKey(uiColor, uiTo);
+}
+
+void GameState::UpdateVictory_()
+{
+    std::array<uint_t, 4> lOrbCount;
+    for (uint_t i = 0; i < 4; ++i)
+        lOrbCount[i] = (lColorMaskList_[i] & MoveGenerator::GetHomeMask(i)).Count();
+
+    if ( (lOrbCount[GREEN] == ORBS_PER_COLOR) && (lOrbCount[PINK] == ORBS_PER_COLOR) )
+        SetState_(STATE_VICTORY2);
+    else if ( (lOrbCount[RED] == ORBS_PER_COLOR) && (lOrbCount[BLUE] == ORBS_PER_COLOR) )
+        SetState_(STATE_VICTORY1);
+}
+
+void GameState::SetState_(State mState)
+{
+    // Only the player to move is part of the hash
+    if ((mState == STATE_PLAYER2) != (mState_ == STATE_PLAYER2))
+        uiHash_ ^= Zobrist::GetPlayerKey();
+
+    mState_ = mState;
+}
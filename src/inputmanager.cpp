@@ -1,16 +1,22 @@
 #include "inputmanager.h"
-#include "inputmanager.h"
 #include "log.h"
 
 #define INPUT_LONGPRESS_DELAY 0.7f
 
 const std::string InputManager::CLASS_NAME = "InputManager";
+const uint_t InputManager::MAX_CLICK_GROUPS;
+const uint_t InputManager::MOUSE_HISTORY_SIZE;
 
 InputManager::InputManager()
 {
     fDoubleClickTime_ = 0.25;
     fMouseHistoryMaxLength_ = 0.03;
     fMouseSensibility_ = 1.0f;
+
+    lKeyDelay_.fill(0.0f);
+    lButtonMX_.fill(0.0f);
+    lButtonMY_.fill(0.0f);
+    lButtonEvent_.fill(false);
 }
 
 InputManager::~InputManager()
@@ -29,41 +35,66 @@ void InputManager::ReadConfig()
 {
 }
 
+uint_t InputManager::GetClickGroupID( const std::string& sGroupName )
+{
+    auto iter = lClickGroupIDList_.find(sGroupName);
+    if (iter != lClickGroupIDList_.end())
+        return iter->second;
+
+    if (lClickGroupIDList_.size() == MAX_CLICK_GROUPS)
+    {
+        throw std::runtime_error(CLASS_NAME+" : Too many input groups (max "+
+            ToString(MAX_CLICK_GROUPS)+") : \""+sGroupName+"\".");
+    }
+
+    uint_t uiGroupID = lClickGroupIDList_.size();
+    lClickGroupIDList_[sGroupName] = uiGroupID;
+    return uiGroupID;
+}
+
 void InputManager::AllowClicks( const std::string& sGroupName )
 {
-    lClickGroupList_[sGroupName] = true;
+    AllowClicks(GetClickGroupID(sGroupName));
+}
+
+void InputManager::AllowClicks( uint_t uiGroupID )
+{
+    mBlockedClickGroups_.reset(uiGroupID);
 }
 
 void InputManager::BlockClicks( const std::string& sGroupName )
 {
-    lClickGroupList_[sGroupName] = false;
+    BlockClicks(GetClickGroupID(sGroupName));
+}
+
+void InputManager::BlockClicks( uint_t uiGroupID )
+{
+    mBlockedClickGroups_.set(uiGroupID);
 }
 
 bool InputManager::CanGroupReceiveClicks( const std::string& sGroupName ) const
 {
-    auto iter = lClickGroupList_.find(sGroupName);
-    if (iter != lClickGroupList_.end())
-    {
-        if (!iter->second)
-        {
-            iter = lForcedClickGroupList_.find(sGroupName);
-            if (iter != lForcedClickGroupList_.end())
-            {
-                return iter->second;
-            }
-            else
-                return false;
-        }
-        else
-            return true;
-    }
-    else
+    // A group that has never been blocked receives clicks
+    auto iter = lClickGroupIDList_.find(sGroupName);
+    if (iter == lClickGroupIDList_.end())
         return true;
+
+    return CanGroupReceiveClicks(iter->second);
+}
+
+bool InputManager::CanGroupReceiveClicks( uint_t uiGroupID ) const
+{
+    return !mBlockedClickGroups_[uiGroupID] || mForcedClickGroups_[uiGroupID];
 }
 
 void InputManager::ForceClicksAllowed( const std::string& sGroupName, bool bForce )
 {
-    lForcedClickGroupList_[sGroupName] = bForce;
+    ForceClicksAllowed(GetClickGroupID(sGroupName), bForce);
+}
+
+void InputManager::ForceClicksAllowed( uint_t uiGroupID, bool bForce )
+{
+    mForcedClickGroups_[uiGroupID] = bForce;
 }
 
 bool InputManager::GetKey( bool bForce ) const
@@ -94,13 +125,7 @@ bool InputManager::KeyIsDown( KeyCode mKey, bool bForce ) const
     if (!bForce && bFocus_)
         return false;
     else
-    {
-        auto iter = lKeyBuf_.find(mKey);
-        if (iter == lKeyBuf_.end())
-            return false;
-        else
-            return iter->second;
-    }
+        return mKeyBuf_[mKey];
 }
 
 bool InputManager::KeyIsDownLong( KeyCode mKey, bool bForce ) const
@@ -108,23 +133,12 @@ bool InputManager::KeyIsDownLong( KeyCode mKey, bool bForce ) const
     if (!bForce && bFocus_)
         return false;
     else
-    {
-        auto iter1 = lKeyBuf_.find(mKey);
-        auto iter2 = lKeyLong_.find(mKey);
-        if (iter1 == lKeyBuf_.end())
-            return false;
-        else
-            return iter1->second && iter2->second;
-    }
+        return mKeyBuf_[mKey] && mKeyLong_[mKey];
 }
 
 float InputManager::GetKeyDownDuration( KeyCode mKey ) const
 {
-    auto iter = lKeyDelay_.find(mKey);
-    if (iter == lKeyDelay_.end())
-        return std::numeric_limits<float>::quiet_NaN();
-    else
-        return iter->second;
+    return lKeyDelay_[mKey];
 }
 
 bool InputManager::KeyIsPressed( KeyCode mKey, bool bForce ) const
@@ -132,14 +146,7 @@ bool InputManager::KeyIsPressed( KeyCode mKey, bool bForce ) const
     if (!bForce && bFocus_)
         return false;
     else
-    {
-        auto iter1 = lKeyBuf_.find(mKey);
-        auto iter2 = lKeyBufOld_.find(mKey);
-        if (iter1 == lKeyBuf_.end())
-            return false;
-        else
-            return iter1->second && !iter2->second;
-    }
+        return mKeyPressed_[mKey];
 }
 
 bool InputManager::KeyIsReleased( KeyCode mKey, bool bForce ) const
@@ -147,14 +154,7 @@ bool InputManager::KeyIsReleased( KeyCode mKey, bool bForce ) const
     if (!bForce && bFocus_)
         return false;
     else
-    {
-        auto iter1 = lKeyBuf_.find(mKey);
-        auto iter2 = lKeyBufOld_.find(mKey);
-        if (iter1 == lKeyBuf_.end())
-            return false;
-        else
-            return !iter1->second && iter2->second;
-    }
+        return mKeyReleased_[mKey];
 }
 
 
@@ -217,18 +217,16 @@ bool InputManager::WheelIsRolled( bool bForce ) const
 
 void InputManager::ClearKeys()
 {
-    lKeyBufOld_ = lKeyBuf_;
+    mKeyBufOld_ = mKeyBuf_;
+    mKeyBuf_.reset();
     iMWheel_ = 0;
-
-    for (auto& p : lKeyBuf_)
-    {
-        p.second = false;
-    }
 }
 
 void InputManager::NotifyKeyPushed( KeyCode mKey )
 {
-    lKeyBuf_[mKey] = true;
+    // Keys unknown to SFML come with a negative code
+    if (mKey >= 0 && mKey < KEY_COUNT)
+        mKeyBuf_.set(mKey);
 }
 
 void InputManager::NotifyMouseWheelMoved( const int& iMovement )
@@ -236,6 +234,73 @@ void InputManager::NotifyMouseWheelMoved( const int& iMovement )
     iMWheel_ = iMovement;
 }
 
+void InputManager::NotifyMouseMoved( int iX, int iY )
+{
+    if (!bHighRateMouse_)
+        return;
+
+    // The first event moves from the position of the last frame
+    if (bMouseMoved_)
+        PushMouseSample_(iX - fEventMX_, iY - fEventMY_);
+    else
+        PushMouseSample_(iX - fMX_, iY - fMY_);
+
+    fEventMX_ = iX;
+    fEventMY_ = iY;
+    bMouseMoved_ = true;
+}
+
+void InputManager::NotifyMouseButton( MouseButton mID, int iX, int iY )
+{
+    if (!bHighRateMouse_)
+        return;
+
+    lButtonMX_[mID] = iX;
+    lButtonMY_[mID] = iY;
+    lButtonEvent_[mID] = true;
+}
+
+void InputManager::PushMouseSample_( float fDX, float fDY )
+{
+    if (uiMouseHistoryCount_ == MOUSE_HISTORY_SIZE)
+    {
+        // Buffer full : drop the oldest movement
+        const MouseSample_& mOldest = lMouseHistory_[uiMouseHistoryStart_];
+        fMouseHistoryDX_ -= mOldest.fDX;
+        fMouseHistoryDY_ -= mOldest.fDY;
+        uiMouseHistoryStart_ = (uiMouseHistoryStart_ + 1) % MOUSE_HISTORY_SIZE;
+        --uiMouseHistoryCount_;
+    }
+
+    MouseSample_& mSample = lMouseHistory_[(uiMouseHistoryStart_ + uiMouseHistoryCount_) % MOUSE_HISTORY_SIZE];
+    mSample.dTime = dTime_;
+    mSample.fDX = fDX;
+    mSample.fDY = fDY;
+    ++uiMouseHistoryCount_;
+
+    fMouseHistoryDX_ += fDX;
+    fMouseHistoryDY_ += fDY;
+}
+
+void InputManager::ExpireMouseSamples_()
+{
+    while (uiMouseHistoryCount_ != 0)
+    {
+        const MouseSample_& mOldest = lMouseHistory_[uiMouseHistoryStart_];
+        if (mOldest.dTime > dTime_ - fMouseHistoryMaxLength_)
+            break;
+
+        fMouseHistoryDX_ -= mOldest.fDX;
+        fMouseHistoryDY_ -= mOldest.fDY;
+        uiMouseHistoryStart_ = (uiMouseHistoryStart_ + 1) % MOUSE_HISTORY_SIZE;
+        --uiMouseHistoryCount_;
+    }
+
+    // Do not let rounding errors pile up
+    if (uiMouseHistoryCount_ == 0)
+        fMouseHistoryDX_ = fMouseHistoryDY_ = 0.0f;
+}
+
 void InputManager::Update( float fTempDelta )
 {
     // Control extreme delta time after loading/at startup etc
@@ -244,39 +309,33 @@ void InputManager::Update( float fTempDelta )
         fDelta = 0.05;
 
     // Update keys
-    bKey_ = false;
+    bKey_ = mKeyBuf_.any();
+    mKeyPressed_ = mKeyBuf_ & ~mKeyBufOld_;
+    mKeyReleased_ = mKeyBufOld_ & ~mKeyBuf_;
 
-    std::map<KeyCode, bool>::iterator iterKey;
-    for (auto& mKey : lKeyBuf_)
+    // Update delays
+    for (uint_t i = 0; i < KEY_COUNT; ++i)
     {
-        KeyCode i = mKey.first;
-
-        // Update delays
-        if (lKeyBufOld_[i])
-        {
+        if (mKeyBufOld_[i])
             lKeyDelay_[i] += fDelta;
-            if (lKeyDelay_[i] >= INPUT_LONGPRESS_DELAY)
-                lKeyLong_[i] = true;
-        }
         else
-        {
             lKeyDelay_[i] = 0.0;
-            lKeyLong_[i] = false;
-        }
 
-        if (lKeyBuf_[i])
+        mKeyLong_[i] = lKeyDelay_[i] >= INPUT_LONGPRESS_DELAY;
+    }
+
+    // The lists only hold the keys of this frame (their memory is kept)
+    lDownStack_.clear();
+    lUpStack_.clear();
+
+    if (mKeyPressed_.any() || mKeyReleased_.any())
+    {
+        for (uint_t i = 0; i < KEY_COUNT; ++i)
         {
-            bKey_ = true;
-            if (!lKeyBufOld_[i])
-            {
-                // Key is pressed
+            if (mKeyPressed_[i])
                 lDownStack_.push_back(i);
-            }
-        }
-        else if (lKeyBufOld_[i])
-        {
-            // Key is released
-            lUpStack_.push_back(i);
+            else if (mKeyReleased_[i])
+                lUpStack_.push_back(i);
         }
     }
 
@@ -286,9 +345,18 @@ void InputManager::Update( float fTempDelta )
     bAltPressed_ = KeyIsDown(KEY_LALT, true) || KeyIsDown(KEY_RALT, true);
 
     // Update mouse state
-    sf::Vector2i mMousePos = sf::Mouse::getPosition(*pWindow_);
-    float fTempMX = mMousePos.x;
-    float fTempMY = mMousePos.y;
+    float fTempMX, fTempMY;
+    if (bHighRateMouse_ && bMouseMoved_)
+    {
+        fTempMX = fEventMX_;
+        fTempMY = fEventMY_;
+    }
+    else
+    {
+        sf::Vector2i mMousePos = sf::Mouse::getPosition(*pWindow_);
+        fTempMX = mMousePos.x;
+        fTempMY = mMousePos.y;
+    }
 
     bool bNewDragged = false;
     bool bMouseState = false, bOldMouseState = false;
@@ -318,6 +386,14 @@ void InputManager::Update( float fTempDelta )
         // Update state
         bMouseState = lMouseBuf_[i] = sf::Mouse::isButtonPressed((sf::Mouse::Button)i);
 
+        // Without a button event, the button changed at the position of this frame
+        if (bMouseState != bOldMouseState && !lButtonEvent_[i])
+        {
+            lButtonMX_[i] = fTempMX;
+            lButtonMY_[i] = fTempMY;
+        }
+        lButtonEvent_[i] = false;
+
         // Handle dragging
         bool bDragStartTest = true;
         if (lMouseState_[i] == MOUSE_DRAGGED)
@@ -374,6 +450,28 @@ void InputManager::Update( float fTempDelta )
     fDMX_ *= fMouseSensibility_;
     fDMY_ *= fMouseSensibility_;
 
+    // In high rate mode, the movements of this frame are already buffered
+    if (!bHighRateMouse_ || !bMouseMoved_)
+        PushMouseSample_(fRawDMX_, fRawDMY_);
+
+    // The next frame reads the mouse again, unless it gets new events
+    bMouseMoved_ = false;
+
+    // The samples pushed until the next frame belong to that frame
+    dTime_ += fDelta;
+    ExpireMouseSamples_();
+
+    // Average the buffered movement over the time it covers (a sample
+    // covers the frame that starts at its time), then scale it to this frame
+    if (uiMouseHistoryCount_ != 0 && dTime_ > lMouseHistory_[uiMouseHistoryStart_].dTime)
+    {
+        float fFactor = fDelta/(dTime_ - lMouseHistory_[uiMouseHistoryStart_].dTime)*fMouseSensibility_;
+        fSmoothDMX_ = fMouseHistoryDX_*fFactor;
+        fSmoothDMY_ = fMouseHistoryDY_*fFactor;
+    }
+    else
+        fSmoothDMX_ = fSmoothDMY_ = 0.0f;
+
     if (iMWheel_ == 0u)
         bWheelRolled_ = false;
     else
@@ -400,6 +498,17 @@ float InputManager::GetMouseBufferDuration() const
     return fMouseHistoryMaxLength_;
 }
 
+void InputManager::SetHighRateMouse( bool bHighRate )
+{
+    bHighRateMouse_ = bHighRate;
+    bMouseMoved_ = false;
+}
+
+bool InputManager::IsHighRateMouse() const
+{
+    return bHighRateMouse_;
+}
+
 void InputManager::SetFocus( bool bFocus )
 {
     bFocus_ = bFocus;
@@ -440,6 +549,16 @@ float InputManager::GetMousePosY() const
     return fMY_;
 }
 
+float InputManager::GetMouseButtonPosX( MouseButton mID ) const
+{
+    return lButtonMX_[mID];
+}
+
+float InputManager::GetMouseButtonPosY( MouseButton mID ) const
+{
+    return lButtonMY_[mID];
+}
+
 float InputManager::GetMouseRawDX() const
 {
     return fRawDMX_;
@@ -460,6 +579,16 @@ float InputManager::GetMouseDY() const
     return fDMY_;
 }
 
+float InputManager::GetMouseSmoothDX() const
+{
+    return fSmoothDMX_;
+}
+
+float InputManager::GetMouseSmoothDY() const
+{
+    return fSmoothDMY_;
+}
+
 const int& InputManager::GetMouseWheel() const
 {
     return iMWheel_;
@@ -0,0 +1,331 @@
+#include "gamestate.h"
+#include "netprotocol.h"
+#include "netsocket.h"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// Both players of a match are played by the same thread, so that the
+    /// time between sending a turn and receiving it from the server is known.
+    struct ClientMatch
+    {
+        GameState mGame;
+        uint_t    uiPly = 0;
+        bool      bClosed = false;
+        Clock::time_point mSentTime;
+        std::array<int, 2> lSocketList = {{-1, -1}};
+        std::array<uint_t, 2> lInSize = {{0, 0}};
+        std::array<std::array<uchar_t, 64>, 2> lInBuffer;
+    };
+
+    struct ThreadResult
+    {
+        std::vector<float> lLatencyList;
+        uint64_t uiGames = 0;
+        uint64_t uiErrors = 0;
+        uint_t   uiMatches = 0;
+    };
+
+    struct Settings
+    {
+        std::string    sAddress = "127.0.0.1";
+        unsigned short uiPort = NetProtocol::DEFAULT_PORT;
+        uint_t         uiMatches = 100;
+        uint_t         uiThreads = 1;
+        float          fDuration = 10.0f;
+    };
+
+    /// The server pairs clients in arrival order : connect the players of
+    /// a match one after the other, and wait for the match to start.
+    std::mutex mSetupMutex;
+
+    /// How long to wait for the server to start a match (in seconds).
+    const int SETUP_TIMEOUT = 5;
+
+    bool SendMessage(int iSocket, const NetMessage& mMessage)
+    {
+        uchar_t lData[NetProtocol::MAX_MESSAGE_SIZE];
+        uint_t uiSize = NetProtocol::Write(mMessage, lData);
+        return send(iSocket, lData, uiSize, MSG_NOSIGNAL) == ssize_t(uiSize);
+    }
+
+    bool OpenMatch(const Settings& mSettings, ClientMatch& mMatch)
+    {
+        for (uint_t uiPlayer = 0; uiPlayer < 2; ++uiPlayer)
+        {
+            int iSocket = ConnectSocket(mSettings.sAddress, mSettings.uiPort);
+            mMatch.lSocketList[uiPlayer] = iSocket;
+            if (iSocket < 0)
+                return false;
+
+            // The sockets are blocking until the match starts : don't wait forever
+            timeval mTimeout;
+            mTimeout.tv_sec = SETUP_TIMEOUT;
+            mTimeout.tv_usec = 0;
+            setsockopt(iSocket, SOL_SOCKET, SO_RCVTIMEO, &mTimeout, sizeof(mTimeout));
+
+            NetMessage mMessage;
+            mMessage.mType = NetMessage::TYPE_HELLO;
+            mMessage.uiPlayer = uiPlayer;
+            if (!SendMessage(iSocket, mMessage))
+                return false;
+        }
+
+        // Blocking read of the HELLO of the server
+        for (uint_t uiPlayer = 0; uiPlayer < 2; ++uiPlayer)
+        {
+            uchar_t lData[NetProtocol::MAX_MESSAGE_SIZE];
+            if (recv(mMatch.lSocketList[uiPlayer], lData, 6, MSG_WAITALL) != 6)
+                return false;
+
+            NetMessage mMessage;
+            if (NetProtocol::Read(lData, 6, mMessage) != 6 || mMessage.uiPlayer != 1 - uiPlayer)
+                return false;
+
+            SetSocketOptions(mMatch.lSocketList[uiPlayer]);
+        }
+
+        return true;
+    }
+
+    bool ConnectMatch(const Settings& mSettings, ClientMatch& mMatch)
+    {
+        std::lock_guard<std::mutex> mLock(mSetupMutex);
+
+        if (OpenMatch(mSettings, mMatch))
+            return true;
+
+        // A player left waiting would be paired with the next match's other player
+        for (int& iSocket : mMatch.lSocketList)
+        {
+            CloseSocket(iSocket);
+            iSocket = -1;
+        }
+
+        return false;
+    }
+
+    void PlayTurn(ClientMatch& mMatch, std::vector<Move>& lMoveList, std::mt19937& mRandom, ThreadResult& mResult)
+    {
+        NetMessage mMessage;
+        mMessage.mType = NetMessage::TYPE_MOVE;
+        mMessage.uiPly = mMatch.uiPly & 0xFFFF;
+
+        // Random turns : the server does the same amount of work whatever the move
+        mMatch.mGame.GenerateMoves(lMoveList);
+        if (!lMoveList.empty())
+            mMessage.mMove = lMoveList[mRandom() % lMoveList.size()];
+
+        int iSocket = mMatch.lSocketList[mMatch.mGame.GetPlayer()];
+        if (mMessage.mMove == Move())
+            mMatch.mGame.EndTurn();
+        else
+            mMatch.mGame.PlayMove(mMessage.mMove);
+
+        ++mMatch.uiPly;
+        mMatch.mSentTime = Clock::now();
+
+        if (!SendMessage(iSocket, mMessage))
+        {
+            ++mResult.uiErrors;
+            mMatch.bClosed = true;
+        }
+    }
+
+    void RunThread(const Settings& mSettings, uint_t uiMatches, uint_t uiSeed, ThreadResult& mResult)
+    {
+        std::vector<ClientMatch> lMatchList(uiMatches);
+        std::vector<Move> lMoveList;
+        std::mt19937 mRandom(uiSeed);
+
+        int iEpoll = epoll_create1(0);
+        for (uint_t i = 0; i < lMatchList.size(); ++i)
+        {
+            ClientMatch& mMatch = lMatchList[i];
+            if (!ConnectMatch(mSettings, mMatch))
+            {
+                ++mResult.uiErrors;
+                mMatch.bClosed = true;
+                continue;
+            }
+
+            for (uint_t uiPlayer = 0; uiPlayer < 2; ++uiPlayer)
+            {
+                epoll_event mEvent;
+                std::memset(&mEvent, 0, sizeof(mEvent));
+                mEvent.events = EPOLLIN;
+                mEvent.data.u64 = 2*i + uiPlayer;
+                epoll_ctl(iEpoll, EPOLL_CTL_ADD, mMatch.lSocketList[uiPlayer], &mEvent);
+            }
+
+            ++mResult.uiMatches;
+        }
+
+        for (auto& mMatch : lMatchList)
+        {
+            if (!mMatch.bClosed)
+                PlayTurn(mMatch, lMoveList, mRandom, mResult);
+        }
+
+        std::array<epoll_event, 256> lEventList;
+        Clock::time_point mEnd = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>(mSettings.fDuration));
+
+        while (Clock::now() < mEnd)
+        {
+            int iCount = epoll_wait(iEpoll, lEventList.data(), lEventList.size(), 100);
+            for (int e = 0; e < iCount; ++e)
+            {
+                ClientMatch& mMatch = lMatchList[lEventList[e].data.u64/2];
+                uint_t uiPlayer = lEventList[e].data.u64 % 2;
+                if (mMatch.bClosed)
+                    continue;
+
+                int iSocket = mMatch.lSocketList[uiPlayer];
+                std::array<uchar_t, 64>& lBuffer = mMatch.lInBuffer[uiPlayer];
+                uint_t& uiSize = mMatch.lInSize[uiPlayer];
+
+                ssize_t iSize = recv(iSocket, lBuffer.data() + uiSize, lBuffer.size() - uiSize, 0);
+                if (iSize <= 0)
+                {
+                    if (iSize < 0 && (errno == EAGAIN || errno == EINTR))
+                        continue;
+
+                    ++mResult.uiErrors;
+                    mMatch.bClosed = true;
+                    continue;
+                }
+
+                uiSize += iSize;
+
+                uint_t uiOffset = 0;
+                NetMessage mMessage;
+                uint_t uiMessageSize;
+                while ((uiMessageSize = NetProtocol::Read(lBuffer.data() + uiOffset, uiSize - uiOffset, mMessage)) != 0)
+                {
+                    // Only the turn of the other player can come : it's our turn now
+                    if (uiMessageSize == npos || mMessage.mType != NetMessage::TYPE_MOVE ||
+                        mMessage.uiPly != ((mMatch.uiPly - 1) & 0xFFFF))
+                    {
+                        ++mResult.uiErrors;
+                        mMatch.bClosed = true;
+                        break;
+                    }
+
+                    uiOffset += uiMessageSize;
+
+                    mResult.lLatencyList.push_back(
+                        std::chrono::duration<float, std::micro>(Clock::now() - mMatch.mSentTime).count());
+
+                    if (mMatch.mGame.IsOver())
+                    {
+                        mMatch.mGame.Reset();
+                        mMatch.uiPly = 0;
+                        ++mResult.uiGames;
+                    }
+
+                    PlayTurn(mMatch, lMoveList, mRandom, mResult);
+                }
+
+                std::memmove(lBuffer.data(), lBuffer.data() + uiOffset, uiSize - uiOffset);
+                uiSize -= uiOffset;
+            }
+        }
+
+        for (auto& mMatch : lMatchList)
+        {
+            for (int iSocket : mMatch.lSocketList)
+                CloseSocket(iSocket);
+        }
+
+        CloseSocket(iEpoll);
+    }
+
+    float GetPercentile(std::vector<float>& lSortedList, float fPercentile)
+    {
+        if (lSortedList.empty())
+            return 0.0f;
+
+        uint_t uiIndex = std::min(uint_t(fPercentile/100.0f*lSortedList.size()), lSortedList.size() - 1);
+        return lSortedList[uiIndex];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Settings mSettings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--address") == 0 && i + 1 < argc)
+            mSettings.sAddress = argv[++i];
+        else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            mSettings.uiPort = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            mSettings.uiMatches = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            mSettings.uiThreads = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+            mSettings.fDuration = std::atof(argv[++i]);
+        else
+        {
+            std::cout << "Usage : orb_loadtest [--address host] [--port N] [--matches N] "
+                "[--threads N] [--duration seconds]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Playing " << mSettings.uiMatches << " matches on " << mSettings.sAddress << ":"
+        << mSettings.uiPort << " with " << mSettings.uiThreads << " threads for "
+        << mSettings.fDuration << " s" << std::endl;
+
+    std::vector<ThreadResult> lResultList(mSettings.uiThreads);
+    std::vector<std::thread> lThreadList;
+    for (uint_t i = 0; i < mSettings.uiThreads; ++i)
+    {
+        uint_t uiMatches = mSettings.uiMatches/mSettings.uiThreads + (i < mSettings.uiMatches % mSettings.uiThreads ? 1 : 0);
+        lThreadList.push_back(std::thread(&RunThread, std::cref(mSettings), uiMatches, i + 1, std::ref(lResultList[i])));
+    }
+
+    for (auto& mThread : lThreadList)
+        mThread.join();
+
+    ThreadResult mTotal;
+    for (auto& mResult : lResultList)
+    {
+        mTotal.lLatencyList.insert(mTotal.lLatencyList.end(), mResult.lLatencyList.begin(), mResult.lLatencyList.end());
+        mTotal.uiGames += mResult.uiGames;
+        mTotal.uiErrors += mResult.uiErrors;
+        mTotal.uiMatches += mResult.uiMatches;
+    }
+
+    std::sort(mTotal.lLatencyList.begin(), mTotal.lLatencyList.end());
+
+    std::cout << std::fixed << std::setprecision(0)
+        << "matches  : " << mTotal.uiMatches << " started, " << mTotal.uiErrors << " errors" << std::endl
+        << "moves    : " << mTotal.lLatencyList.size() << " (" << mTotal.lLatencyList.size()/mSettings.fDuration
+        << " moves/s), " << mTotal.uiGames << " games finished" << std::endl
+        << std::setprecision(1)
+        << "latency  : p50 " << GetPercentile(mTotal.lLatencyList, 50.0f)
+        << " us, p90 " << GetPercentile(mTotal.lLatencyList, 90.0f)
+        << " us, p99 " << GetPercentile(mTotal.lLatencyList, 99.0f)
+        << " us, p99.9 " << GetPercentile(mTotal.lLatencyList, 99.9f)
+        << " us, max " << (mTotal.lLatencyList.empty() ? 0.0f : mTotal.lLatencyList.back()) << " us" << std::endl;
+
+    return mTotal.uiErrors == 0 ? 0 : 1;
+}
@@ -2,69 +2,514 @@
 
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 
-#include <SFML/System/Clock.hpp>
-
-void Log( const std::string& sMessage, bool bTimeStamps, uint_t uiOffset )
+namespace
 {
-    static std::ofstream mLog("Orb.log");
-    static sf::Clock mClock;
+    typedef std::chrono::steady_clock Clock;
+
+    std::atomic<int> iLogLevel(LOG_INFO);
+
+    /// Threads are numbered in the order of their first message
+    std::atomic<uint_t> uiNextThread(0);
 
-    std::string sNewMessage;
-    if (bTimeStamps)
+    uint_t GetThreadNumber()
     {
-        if (sMessage[0] == '|' && sMessage[1] == 't')
+        thread_local uint_t uiThread = uiNextThread++;
+        return uiThread;
+    }
+
+    const char* GetLevelName(LogLevel mLevel)
+    {
+        switch (mLevel)
         {
-            sNewMessage = sMessage;
-            sNewMessage = Replace(sNewMessage, "\n", "\n"+std::string(uiOffset, ' '));
-            sNewMessage = sNewMessage.substr(2);
+            case LOG_TRACE :   return "trace";
+            case LOG_DEBUG :   return "debug";
+            case LOG_INFO :    return "info";
+            case LOG_WARNING : return "warning";
+            case LOG_ERROR :   return "error";
         }
-        else
+
+        return "";
+    }
+
+    /// A message waiting to be written
+    struct LogRecord
+    {
+        LogLevel mLevel = LOG_INFO;
+        Clock::time_point mTime;
+        uint_t uiThread = 0;
+        std::string sClass;
+        std::string sMessage;
+        uint_t uiOffset = 0;
+        bool bTimeStamps = false;
+        /// If not null, the log is flushed and this is set when the record is reached
+        std::atomic<bool>* pFlushed = nullptr;
+    };
+
+    /// Writes the log from a background thread.
+    /** Messages are pushed in a bounded lock-free queue (any thread can push,
+    *   only the log thread pops), and written by batches : the files are only
+    *   flushed when the queue is empty, or when asked by FlushLog().<br>
+    *   Messages are written as text to the console and to Orb.log, and
+    *   optionally as JSON lines (see SetLogJSONFile()).
+    */
+    class LogBackend
+    {
+    public :
+
+        LogBackend() : mStart_(Clock::now()), mFile_("Orb.log"), lCellList_(QUEUE_SIZE)
         {
-            float fTime = mClock.getElapsedTime().asSeconds();
+            for (uint_t i = 0; i < QUEUE_SIZE; ++i)
+                lCellList_[i].uiSequence = i;
+
+            mThread_ = std::thread(&LogBackend::Run_, this);
+        }
 
-            uint_t uiHours(std::floor(fTime/3600.0));
-            fTime -= float(uiHours)*3600.0;
-            uint_t uiMinutes(std::floor(fTime/60.0));
-            fTime -= float(uiMinutes)*60.0;
-            uint_t uiSeconds(std::floor(fTime));
-            fTime -= float(uiSeconds);
-            uint_t uiMilliseconds(std::floor(fTime*1000));
+        /// Queues a message (waits if the queue is full).
+        void Push(LogRecord& mRecord)
+        {
+            // Counted so that Stop() waits for the messages being queued
+            ++uiPushCount_;
+            if (!bStopped_)
+            {
+                while (!TryPush_(mRecord))
+                {
+                    mWakeCondition_.notify_one();
+                    std::this_thread::yield();
+                }
+
+                mWakeCondition_.notify_one();
+                --uiPushCount_;
+                return;
+            }
+            --uiPushCount_;
+
+            // The log thread is gone (program exit) : write directly
+            std::lock_guard<std::mutex> mLock(mDirectMutex_);
+            WriteDirect_(mRecord);
+        }
+
+        /// Waits until all the messages queued by this thread are written.
+        void Flush()
+        {
+            std::atomic<bool> bFlushed(false);
+            LogRecord mRecord;
+            mRecord.pFlushed = &bFlushed;
+            Push(mRecord);
+
+            std::unique_lock<std::mutex> mLock(mFlushMutex_);
+            mFlushCondition_.wait(mLock, [&]() { return bFlushed.load(); });
+        }
+
+        bool SetJSONFile(const std::string& sFile)
+        {
+            std::lock_guard<std::mutex> mLock(mJSONMutex_);
+            if (mJSONFile_.is_open())
+                mJSONFile_.close();
+
+            bJSON_ = false;
+            if (sFile.empty())
+                return true;
+
+            mJSONFile_.open(sFile);
+            bJSON_ = mJSONFile_.is_open();
+            return bJSON_;
+        }
+
+        /// Writes the remaining messages and stops the log thread.
+        void Stop()
+        {
+            if (bStopped_ || !mThread_.joinable())
+                return;
+
+            bStopRequested_ = true;
+            mWakeCondition_.notify_one();
+            mThread_.join();
+
+            // From now on, messages are written directly by Push() ; those queued
+            // after the log thread made its last check are written here
+            bStopped_ = true;
+
+            std::lock_guard<std::mutex> mLock(mDirectMutex_);
+            LogRecord mRecord;
+            while (true)
+            {
+                bool bIdle = uiPushCount_ == 0;
+                while (TryPop_(mRecord))
+                    WriteDirect_(mRecord);
+
+                if (bIdle)
+                    break;
+
+                std::this_thread::yield();
+            }
+        }
+
+    private :
+
+        struct Cell_
+        {
+            std::atomic<uint_t> uiSequence;
+            LogRecord mRecord;
+        };
+
+        static const uint_t QUEUE_SIZE = 4096; // must be a power of two
+
+        /// Bounded multi-producer queue (see D. Vyukov's MPMC queue).
+        /** Each cell holds a sequence number telling if it can be written
+        *   (sequence == position) or read (sequence == position + 1).
+        */
+        bool TryPush_(LogRecord& mRecord)
+        {
+            uint_t uiPos = uiPushPos_.load(std::memory_order_relaxed);
+            Cell_* pCell;
+            while (true)
+            {
+                pCell = &lCellList_[uiPos & (QUEUE_SIZE - 1)];
+                uint_t uiSequence = pCell->uiSequence.load(std::memory_order_acquire);
+                std::ptrdiff_t iDiff = std::ptrdiff_t(uiSequence) - std::ptrdiff_t(uiPos);
+                if (iDiff == 0)
+                {
+                    if (uiPushPos_.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (iDiff < 0)
+                    return false; // full
+                else
+                    uiPos = uiPushPos_.load(std::memory_order_relaxed);
+            }
+
+            pCell->mRecord = std::move(mRecord);
+            pCell->uiSequence.store(uiPos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool TryPop_(LogRecord& mRecord)
+        {
+            Cell_& mCell = lCellList_[uiPopPos_ & (QUEUE_SIZE - 1)];
+            if (mCell.uiSequence.load(std::memory_order_acquire) != uiPopPos_ + 1)
+                return false;
+
+            mRecord = std::move(mCell.mRecord);
+            mCell.uiSequence.store(uiPopPos_ + QUEUE_SIZE, std::memory_order_release);
+            ++uiPopPos_;
+            return true;
+        }
+
+        void Run_()
+        {
+            std::string sBuffer, sJSONBuffer;
+            LogRecord mRecord;
+
+            while (true)
+            {
+                bool bStop = bStopRequested_;
+
+                // Gather everything that is queued, and write it at once
+                while (TryPop_(mRecord))
+                {
+                    if (mRecord.pFlushed)
+                    {
+                        Write_(sBuffer, sJSONBuffer);
+                        Flush_();
+                        sBuffer.clear();
+                        sJSONBuffer.clear();
+
+                        SetFlushed_(mRecord);
+                        continue;
+                    }
+
+                    FormatText_(mRecord, sBuffer);
+                    if (bJSON_)
+                        FormatJSON_(mRecord, sJSONBuffer);
+                }
+
+                if (!sBuffer.empty())
+                {
+                    Write_(sBuffer, sJSONBuffer);
+                    Flush_();
+                    sBuffer.clear();
+                    sJSONBuffer.clear();
+                    continue;
+                }
+
+                if (bStop)
+                    break;
+
+                // Producers do not lock the mutex : a missed notification only delays the log
+                std::unique_lock<std::mutex> mLock(mWakeMutex_);
+                mWakeCondition_.wait_for(mLock, std::chrono::milliseconds(10));
+            }
+        }
+
+        /// Writes a message at once (when the log thread is stopped).
+        void WriteDirect_(const LogRecord& mRecord)
+        {
+            if (mRecord.pFlushed)
+            {
+                SetFlushed_(mRecord);
+                return;
+            }
 
-            std::string sTime = "[";
-            sTime += ToString(uiHours) + ":";
-            sTime += ToString(uiMinutes) + ":";
-            sTime += ToString(uiSeconds) + ":";
-            sTime += ToString(uiMilliseconds) + "] : ";
+            std::string sBuffer, sJSONBuffer;
+            FormatText_(mRecord, sBuffer);
+            if (bJSON_)
+                FormatJSON_(mRecord, sJSONBuffer);
 
-            sNewMessage = sTime+sMessage;
-            sNewMessage = Replace(sNewMessage, "\n", "\n"+sTime+std::string(uiOffset, ' '));
+            Write_(sBuffer, sJSONBuffer);
+            Flush_();
         }
+
+        /// Wakes up the thread waiting in Flush() for this record.
+        void SetFlushed_(const LogRecord& mRecord)
+        {
+            std::lock_guard<std::mutex> mLock(mFlushMutex_);
+            *mRecord.pFlushed = true;
+            mFlushCondition_.notify_all();
+        }
+
+        /// Returns where the message starts ("|t" at the start removes the time stamp).
+        static std::string::size_type GetMessageStart_(const LogRecord& mRecord)
+        {
+            const std::string& sMessage = mRecord.sMessage;
+            if (mRecord.bTimeStamps && sMessage.size() >= 2 && sMessage[0] == '|' && sMessage[1] == 't')
+                return 2;
+            else
+                return 0;
+        }
+
+        /// Formats a message for humans : time stamp, level, class, then indented lines.
+        void FormatText_(const LogRecord& mRecord, std::string& sBuffer)
+        {
+            const std::string& sMessage = mRecord.sMessage;
+            std::string::size_type uiStart = GetMessageStart_(mRecord);
+            std::string sTime;
+
+            if (mRecord.bTimeStamps && uiStart == 0)
+                sTime = FormatTime_(mRecord.mTime);
+
+            std::string sHeader;
+            switch (mRecord.mLevel)
+            {
+                case LOG_TRACE :   sHeader = "# Trace # : "; break;
+                case LOG_DEBUG :   sHeader = "# Debug # : "; break;
+                case LOG_WARNING : sHeader = "# Warning # : "; break;
+                case LOG_ERROR :   sHeader = "# Error # : "; break;
+                case LOG_INFO :    break;
+            }
+
+            if (!mRecord.sClass.empty())
+                sHeader += mRecord.sClass + " : ";
+
+            sBuffer += sTime;
+            sBuffer += sHeader;
+
+            // Following lines get the same time stamp, and are indented
+            std::string sIndent = sTime + std::string(sHeader.empty() ? mRecord.uiOffset : sHeader.size(), ' ');
+            std::string::size_type uiPos;
+            while ((uiPos = sMessage.find('\n', uiStart)) != std::string::npos)
+            {
+                sBuffer.append(sMessage, uiStart, uiPos + 1 - uiStart);
+                sBuffer += sIndent;
+                uiStart = uiPos + 1;
+            }
+
+            sBuffer.append(sMessage, uiStart, std::string::npos);
+            sBuffer += '\n';
+        }
+
+        /// Formats a message as a JSON object, on a single line.
+        void FormatJSON_(const LogRecord& mRecord, std::string& sBuffer)
+        {
+            char sTime[32];
+            std::snprintf(sTime, sizeof(sTime), "%.6f",
+                std::chrono::duration<double>(mRecord.mTime - mStart_).count());
+
+            sBuffer += "{\"time\":";
+            sBuffer += sTime;
+            sBuffer += ",\"level\":\"";
+            sBuffer += GetLevelName(mRecord.mLevel);
+            sBuffer += "\",\"thread\":";
+            sBuffer += ToString(mRecord.uiThread);
+            sBuffer += ",\"class\":";
+            AppendJSONString_(mRecord.sClass, 0, sBuffer);
+            sBuffer += ",\"message\":";
+            AppendJSONString_(mRecord.sMessage, GetMessageStart_(mRecord), sBuffer);
+            sBuffer += "}\n";
+        }
+
+        static void AppendJSONString_(const std::string& sString, std::string::size_type uiStart, std::string& sBuffer)
+        {
+            sBuffer += '"';
+            for (std::string::size_type i = uiStart; i < sString.size(); ++i)
+            {
+                unsigned char c = sString[i];
+                switch (c)
+                {
+                    case '"' :  sBuffer += "\\\""; break;
+                    case '\\' : sBuffer += "\\\\"; break;
+                    case '\n' : sBuffer += "\\n"; break;
+                    case '\r' : sBuffer += "\\r"; break;
+                    case '\t' : sBuffer += "\\t"; break;
+                    default :
+                        if (c < 0x20)
+                        {
+                            char sEscape[8];
+                            std::snprintf(sEscape, sizeof(sEscape), "\\u%04x", c);
+                            sBuffer += sEscape;
+                        }
+                        else
+                            sBuffer += char(c);
+                }
+            }
+            sBuffer += '"';
+        }
+
+        /// Returns "[h:m:s:ms] : ", the "[h:m:s:" part being only formatted once per second.
+        std::string FormatTime_(const Clock::time_point& mTime)
+        {
+            uint64_t uiMilliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(mTime - mStart_).count();
+            uint64_t uiSeconds = uiMilliseconds/1000;
+
+            if (uiSeconds != uiCachedSeconds_ || sCachedTime_.empty())
+            {
+                char sTime[32];
+                std::snprintf(sTime, sizeof(sTime), "[%lu:%lu:%lu:", (unsigned long)(uiSeconds/3600),
+                    (unsigned long)((uiSeconds/60) % 60), (unsigned long)(uiSeconds % 60));
+                sCachedTime_ = sTime;
+                uiCachedSeconds_ = uiSeconds;
+            }
+
+            return sCachedTime_ + ToString(uiMilliseconds % 1000) + "] : ";
+        }
+
+        void Write_(const std::string& sBuffer, const std::string& sJSONBuffer)
+        {
+            std::cout.write(sBuffer.data(), sBuffer.size());
+            mFile_.write(sBuffer.data(), sBuffer.size());
+
+            if (!sJSONBuffer.empty())
+            {
+                std::lock_guard<std::mutex> mLock(mJSONMutex_);
+                if (mJSONFile_.is_open())
+                    mJSONFile_.write(sJSONBuffer.data(), sJSONBuffer.size());
+            }
+        }
+
+        void Flush_()
+        {
+            std::cout.flush();
+            mFile_.flush();
+
+            std::lock_guard<std::mutex> mLock(mJSONMutex_);
+            if (mJSONFile_.is_open())
+                mJSONFile_.flush();
+        }
+
+        Clock::time_point mStart_;
+        std::ofstream     mFile_;
+
+        std::mutex        mJSONMutex_;
+        std::ofstream     mJSONFile_;
+        std::atomic<bool> bJSON_ = {false};
+
+        std::vector<Cell_>  lCellList_;
+        std::atomic<uint_t> uiPushPos_ = {0};
+        uint_t              uiPopPos_ = 0;
+
+        std::thread             mThread_;
+        std::mutex              mWakeMutex_;
+        std::condition_variable mWakeCondition_;
+        std::mutex              mFlushMutex_;
+        std::condition_variable mFlushCondition_;
+        std::mutex              mDirectMutex_;
+        std::atomic<bool>       bStopRequested_ = {false};
+        std::atomic<bool>       bStopped_ = {false};
+        std::atomic<uint_t>     uiPushCount_ = {0};
+
+        uint64_t    uiCachedSeconds_ = 0;
+        std::string sCachedTime_;
+    };
+
+    void StopLog();
+
+    LogBackend& GetLogBackend()
+    {
+        // Never deleted : messages logged during the destruction of static
+        // objects are written directly, once the log thread has been stopped
+        static LogBackend* pBackend = []() {
+            LogBackend* pNew = new LogBackend();
+            std::atexit(&StopLog);
+            return pNew;
+        }();
+
+        return *pBackend;
     }
-    else
+
+    void StopLog()
     {
-        sNewMessage = sMessage;
-        sNewMessage = Replace(sNewMessage, "\n", "\n"+std::string(uiOffset, ' '));
+        GetLogBackend().Stop();
     }
+}
+
+void SetLogLevel( LogLevel mLevel )
+{
+    iLogLevel = mLevel;
+}
 
-    std::cout << sNewMessage << std::endl;
-    mLog << sNewMessage << std::endl;
+LogLevel GetLogLevel()
+{
+    return (LogLevel)iLogLevel.load();
 }
 
-void Error( const std::string& sClass, const std::string& sMessage )
+bool IsLogEnabled( LogLevel mLevel )
 {
-    std::string sHeader = "# Error # : ";
-    if (sClass != "")
-        sHeader += sClass + " : ";
+    return mLevel >= ORB_LOG_LEVEL && mLevel >= iLogLevel.load(std::memory_order_relaxed);
+}
 
-    Log(sHeader + sMessage, true, sHeader.size());
+bool SetLogJSONFile( const std::string& sFile )
+{
+    return GetLogBackend().SetJSONFile(sFile);
 }
 
-void Warning( const std::string& sClass, const std::string& sMessage )
+void WriteLog( LogLevel mLevel, const std::string& sClass, const std::string& sMessage )
 {
-    std::string sHeader = "# Warning # : ";
-    if (sClass != "")
-        sHeader += sClass + " : ";
+    LogRecord mRecord;
+    mRecord.mLevel = mLevel;
+    mRecord.mTime = Clock::now();
+    mRecord.uiThread = GetThreadNumber();
+    mRecord.sClass = sClass;
+    mRecord.sMessage = sMessage;
+    mRecord.bTimeStamps = true;
+    GetLogBackend().Push(mRecord);
 
-    Log(sHeader + sMessage, true, sHeader.size());
+    // Make sure errors are written, in case the program stops
+    if (mLevel == LOG_ERROR)
+        FlushLog();
+}
+
+void Log( const std::string& sMessage, bool bTimeStamps, uint_t uiOffset )
+{
+    if (!IsLogEnabled(LOG_INFO))
+        return;
+
+    LogRecord mRecord;
+    mRecord.mTime = Clock::now();
+    mRecord.uiThread = GetThreadNumber();
+    mRecord.sMessage = sMessage;
+    mRecord.uiOffset = uiOffset;
+    mRecord.bTimeStamps = bTimeStamps;
+    GetLogBackend().Push(mRecord);
+}
+
+void FlushLog()
+{
+    GetLogBackend().Flush();
 }
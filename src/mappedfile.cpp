@@ -0,0 +1,100 @@
+#include "mappedfile.h"
+
+#ifdef POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& sFile)
+{
+    Close();
+
+#ifdef POSIX
+    int iFile = ::open(sFile.c_str(), O_RDONLY);
+    if (iFile < 0)
+        return false;
+
+    struct stat mStat;
+    if (::fstat(iFile, &mStat) != 0 || mStat.st_size <= 0)
+    {
+        ::close(iFile);
+        return false;
+    }
+
+    void* pData = ::mmap(nullptr, mStat.st_size, PROT_READ, MAP_PRIVATE, iFile, 0);
+
+    // The mapping stays valid after the file is closed
+    ::close(iFile);
+
+    if (pData == MAP_FAILED)
+        return false;
+
+    pData_ = static_cast<const uchar_t*>(pData);
+    uiSize_ = mStat.st_size;
+#else
+    std::ifstream mFile(sFile, std::ios::binary | std::ios::ate);
+    if (!mFile.is_open())
+        return false;
+
+    std::streamoff iSize = mFile.tellg();
+    if (iSize <= 0)
+        return false;
+
+    lBuffer_.resize(uint_t(iSize));
+    mFile.seekg(0);
+    if (!mFile.read(reinterpret_cast<char*>(lBuffer_.data()), iSize))
+    {
+        lBuffer_.clear();
+        return false;
+    }
+
+    pData_ = lBuffer_.data();
+    uiSize_ = lBuffer_.size();
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!pData_)
+        return;
+
+#ifdef POSIX
+    ::munmap(const_cast<uchar_t*>(pData_), uiSize_);
+#else
+    lBuffer_.clear();
+    lBuffer_.shrink_to_fit();
+#endif
+
+    pData_ = nullptr;
+    uiSize_ = 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return pData_ != nullptr;
+}
+
+const uchar_t* MappedFile::GetData() const
+{
+    return pData_;
+}
+
+uint_t MappedFile::GetSize() const
+{
+    return uiSize_;
+}
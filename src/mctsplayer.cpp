@@ -0,0 +1,283 @@
+#include "mctsplayer.h"
+#include "aiplayer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    /// Difference of distance to home that gives a 73% chance of winning
+    const float EVALUATION_SCALE = 10.0f;
+
+    /// Returns by how many steps a move brings an orb closer to its home.
+    int GetGain(const GameState& mGame, const Move& mMove)
+    {
+        uint_t uiColor = mGame.GetOrbColor(mGame.GetOrbAt(uint_t(mMove.uiFrom)));
+        return AIPlayer::GetHomeDistance(uiColor, mMove.uiFrom) - AIPlayer::GetHomeDistance(uiColor, mMove.uiTo);
+    }
+}
+
+MCTSPlayer::MCTSPlayer()
+{
+}
+
+void MCTSPlayer::SetExploration(float fExploration)
+{
+    fExploration_ = fExploration;
+}
+
+float MCTSPlayer::GetExploration() const
+{
+    return fExploration_;
+}
+
+void MCTSPlayer::SetPlayoutLength(uint_t uiPlayoutLength)
+{
+    uiPlayoutLength_ = uiPlayoutLength;
+}
+
+void MCTSPlayer::SetRandomness(float fRandomness)
+{
+    fRandomness_ = fRandomness;
+}
+
+Move MCTSPlayer::Search(const GameState& mGame)
+{
+    StartSearch_();
+
+    mRoot_ = mGame;
+    lNodeList_.clear();
+    lNodeList_.push_back(Node_());
+    lNodeList_[0].uiPlayer = 1 - mGame.GetPlayer();
+    uiMaxDepth_ = 0;
+
+    std::random_device mSeed;
+    lThreadList_.resize(uiThreadCount_);
+    for (auto& mThread : lThreadList_)
+    {
+        mThread.mRandom.seed(mSeed());
+        mThread.uiPlayouts = 0;
+    }
+
+    std::vector<std::thread> lHelperList;
+    for (uint_t i = 1; i < uiThreadCount_; ++i)
+        lHelperList.push_back(std::thread(&MCTSPlayer::Work_, this, std::ref(lThreadList_[i])));
+
+    Work_(lThreadList_[0]);
+
+    for (auto& mHelper : lHelperList)
+        mHelper.join();
+
+    // Play the most explored move
+    Move mBestMove;
+    const Node_& mRoot = lNodeList_[0];
+    uint_t uiBestVisits = 0;
+    for (uint_t i = mRoot.uiFirstChild; i < mRoot.uiFirstChild + mRoot.uiChildCount; ++i)
+    {
+        const Node_& mChild = lNodeList_[i];
+        if (mChild.uiVisits > uiBestVisits)
+        {
+            uiBestVisits = mChild.uiVisits;
+            mBestMove = mChild.mMove;
+            mLastInfo_.iScore = int(1000.0f*mChild.fWins/mChild.uiVisits);
+        }
+    }
+
+    if (uiBestVisits == 0 && mRoot.uiChildCount != 0)
+        mBestMove = lNodeList_[mRoot.uiFirstChild].mMove;
+
+    for (auto& mThread : lThreadList_)
+        mLastInfo_.uiNodes += mThread.uiPlayouts;
+
+    mLastInfo_.uiDepth = uiMaxDepth_;
+    EndSearch_();
+
+    return mBestMove;
+}
+
+void MCTSPlayer::Work_(SearchThread_& mThread)
+{
+    while (!bStop_)
+    {
+        Iterate_(mThread);
+
+        if (IsTimeOut_())
+            bStop_ = true;
+    }
+}
+
+void MCTSPlayer::Iterate_(SearchThread_& mThread)
+{
+    GameState& mGame = mThread.mGame;
+    mGame = mRoot_;
+    mThread.lPath.clear();
+
+    {
+        std::lock_guard<std::mutex> mLock(mTreeMutex_);
+
+        // Walk down the tree
+        uint_t uiNode = 0;
+        mThread.lPath.push_back(uiNode);
+        ++lNodeList_[uiNode].uiVirtualLoss;
+
+        while (lNodeList_[uiNode].bExpanded && lNodeList_[uiNode].uiChildCount != 0)
+        {
+            uiNode = SelectChild_(lNodeList_[uiNode]);
+            PlayMove_(mGame, lNodeList_[uiNode].mMove);
+            mThread.lPath.push_back(uiNode);
+            ++lNodeList_[uiNode].uiVirtualLoss;
+        }
+
+        // Only grow the tree under nodes that have already been visited once,
+        // else most of the memory would go to moves that are never tried
+        const Node_& mLeaf = lNodeList_[uiNode];
+        if (!mLeaf.bExpanded && !mGame.IsOver() && (uiNode == 0 || mLeaf.uiVisits > 0) &&
+            lNodeList_.size() < MAX_NODES)
+        {
+            Expand_(uiNode, mThread);
+
+            uiNode = SelectChild_(lNodeList_[uiNode]);
+            PlayMove_(mGame, lNodeList_[uiNode].mMove);
+            mThread.lPath.push_back(uiNode);
+            ++lNodeList_[uiNode].uiVirtualLoss;
+        }
+
+        uiMaxDepth_ = std::max(uiMaxDepth_, uint_t(mThread.lPath.size() - 1));
+    }
+
+    float fResult = Playout_(mThread);
+
+    {
+        std::lock_guard<std::mutex> mLock(mTreeMutex_);
+
+        for (auto uiNode : mThread.lPath)
+        {
+            Node_& mNode = lNodeList_[uiNode];
+            --mNode.uiVirtualLoss;
+            ++mNode.uiVisits;
+            mNode.fWins += mNode.uiPlayer == 0 ? fResult : 1.0f - fResult;
+        }
+    }
+
+    ++mThread.uiPlayouts;
+}
+
+uint_t MCTSPlayer::SelectChild_(const Node_& mNode) const
+{
+    // Running playouts count as losses
+    float fLogVisits = std::log(float(std::max(mNode.uiVisits + mNode.uiVirtualLoss, uint_t(1))));
+
+    uint_t uiBest = mNode.uiFirstChild;
+    float fBestValue = -1.0f;
+    for (uint_t i = mNode.uiFirstChild; i < mNode.uiFirstChild + mNode.uiChildCount; ++i)
+    {
+        const Node_& mChild = lNodeList_[i];
+        uint_t uiVisits = mChild.uiVisits + mChild.uiVirtualLoss;
+
+        // Children are sorted from the most promising move : try them in order
+        if (uiVisits == 0)
+            return i;
+
+        float fValue = mChild.fWins/uiVisits + fExploration_*std::sqrt(fLogVisits/uiVisits);
+        if (fValue > fBestValue)
+        {
+            fBestValue = fValue;
+            uiBest = i;
+        }
+    }
+
+    return uiBest;
+}
+
+void MCTSPlayer::Expand_(uint_t uiNode, SearchThread_& mThread)
+{
+    const GameState& mGame = mThread.mGame;
+    std::vector<Move>& lMoveList = mThread.lMoveList;
+    mGame.GenerateMoves(lMoveList);
+
+    std::stable_sort(lMoveList.begin(), lMoveList.end(), [&](const Move& mMove1, const Move& mMove2) {
+        return GetGain(mGame, mMove1) > GetGain(mGame, mMove2);
+    });
+
+    // No legal move : the only child is a pass, so every expanded node has children
+    if (lMoveList.empty())
+        lMoveList.push_back(Move());
+
+    uint_t uiFirstChild = lNodeList_.size();
+    for (auto& mMove : lMoveList)
+    {
+        Node_ mChild;
+        mChild.mMove = mMove;
+        mChild.uiPlayer = mGame.GetPlayer();
+        lNodeList_.push_back(mChild);
+    }
+
+    Node_& mNode = lNodeList_[uiNode];
+    mNode.bExpanded = true;
+    mNode.uiFirstChild = uiFirstChild;
+    mNode.uiChildCount = lMoveList.size();
+}
+
+float MCTSPlayer::Playout_(SearchThread_& mThread)
+{
+    GameState& mGame = mThread.mGame;
+    for (uint_t i = 0; i < uiPlayoutLength_ && !mGame.IsOver(); ++i)
+        PlayMove_(mGame, ChoosePlayoutMove_(mThread));
+
+    if (mGame.GetState() == GameState::STATE_VICTORY1)
+        return 1.0f;
+    else if (mGame.GetState() == GameState::STATE_VICTORY2)
+        return 0.0f;
+
+    // No winner yet : guess the chances of player 1 from the distance of the orbs to their home
+    float fScore = AIPlayer::Evaluate(mGame);
+    if (mGame.GetPlayer() == 1)
+        fScore = -fScore;
+
+    return 1.0f/(1.0f + std::exp(-fScore/EVALUATION_SCALE));
+}
+
+Move MCTSPlayer::ChoosePlayoutMove_(SearchThread_& mThread)
+{
+    const GameState& mGame = mThread.mGame;
+    std::vector<Move>& lMoveList = mThread.lMoveList;
+    mGame.GenerateMoves(lMoveList);
+
+    // No legal move : pass
+    if (lMoveList.empty())
+        return Move();
+
+    if (std::uniform_real_distribution<float>(0.0f, 1.0f)(mThread.mRandom) < fRandomness_)
+        return lMoveList[std::uniform_int_distribution<uint_t>(0, lMoveList.size() - 1)(mThread.mRandom)];
+
+    // Pick one of the moves that bring an orb closest to its home
+    int iBestGain = std::numeric_limits<int>::min();
+    uint_t uiBestCount = 0;
+    Move mBestMove;
+    for (auto& mMove : lMoveList)
+    {
+        int iGain = GetGain(mGame, mMove);
+        if (iGain > iBestGain)
+        {
+            iBestGain = iGain;
+            uiBestCount = 1;
+            mBestMove = mMove;
+        }
+        else if (iGain == iBestGain)
+        {
+            ++uiBestCount;
+            if (std::uniform_int_distribution<uint_t>(0, uiBestCount - 1)(mThread.mRandom) == 0)
+                mBestMove = mMove;
+        }
+    }
+
+    return mBestMove;
+}
+
+void MCTSPlayer::PlayMove_(GameState& mGame, const Move& mMove)
+{
+    if (mMove == Move())
+        mGame.EndTurn();
+    else
+        mGame.PlayMove(mMove);
+}
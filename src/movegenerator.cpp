@@ -0,0 +1,283 @@
+#include "movegenerator.h"
+
+#include <algorithm>
+
+namespace
+{
+    const int DIRECTION_X[MoveGenerator::DIR_COUNT] = { 1, -1,  0,  0,  1, -1, -1,  1};
+    const int DIRECTION_Y[MoveGenerator::DIR_COUNT] = { 0,  0,  1, -1,  1, -1,  1, -1};
+
+    int GetOffset(uint_t uiDirection)
+    {
+        return DIRECTION_X[uiDirection] + BitBoard::WIDTH*DIRECTION_Y[uiDirection];
+    }
+
+    /// Lookup tables, built on first use.
+    struct Tables
+    {
+        Tables()
+        {
+            for (uint_t i = 0; i < BitBoard::SIZE; ++i)
+            {
+                Slot mSlot = BitBoard::GetSlot(i);
+                int iX = mSlot.X(), iY = mSlot.Y();
+
+                if (!IsInRange(iX, 2, 7) && !IsInRange(iY, 2, 7))
+                    continue;
+
+                mBoard.Set(i);
+
+                if (IsInRange(iX, 2, 7))
+                {
+                    if (iY > 7)
+                        lHomeList[0].Set(i);
+                    else if (iY < 2)
+                        lHomeList[1].Set(i);
+                }
+                else
+                {
+                    if (iX > 7)
+                        lHomeList[2].Set(i);
+                    else
+                        lHomeList[3].Set(i);
+                }
+            }
+
+            for (uint_t d = 0; d < MoveGenerator::DIR_COUNT; ++d)
+            {
+                lColumnGuard[d] = mBoard;
+                for (int j = 0; j < BitBoard::WIDTH; ++j)
+                {
+                    if (DIRECTION_X[d] > 0)
+                        lColumnGuard[d].Reset(BitBoard::GetIndex(Slot(BitBoard::WIDTH - 1, j)));
+                    else if (DIRECTION_X[d] < 0)
+                        lColumnGuard[d].Reset(BitBoard::GetIndex(Slot(0, j)));
+                }
+            }
+
+            for (uint_t i = 0; i < BitBoard::SIZE; ++i)
+            {
+                if (!mBoard.Test(i))
+                    continue;
+
+                for (uint_t d = 0; d < MoveGenerator::DIR_COUNT; ++d)
+                {
+                    // Walk in the given direction until we leave the board
+                    BitBoard mStep = Shift(BitBoard::FromIndex(i), d);
+                    lNeighborList[i] |= mStep;
+                    while (!mStep.IsEmpty())
+                    {
+                        lRayList[i][d] |= mStep;
+                        mStep = Shift(mStep, d);
+                    }
+                }
+            }
+        }
+
+        BitBoard Shift(const BitBoard& mBits, uint_t uiDirection) const
+        {
+            int iOffset = GetOffset(uiDirection);
+            BitBoard mGuarded = mBits & lColumnGuard[uiDirection];
+            if (iOffset > 0)
+                return (mGuarded << uint_t(iOffset)) & mBoard;
+            else
+                return (mGuarded >> uint_t(-iOffset)) & mBoard;
+        }
+
+        BitBoard mBoard;
+        std::array<BitBoard, 4> lHomeList;
+        std::array<BitBoard, MoveGenerator::DIR_COUNT> lColumnGuard;
+        std::array<BitBoard, BitBoard::SIZE> lNeighborList;
+        std::array<std::array<BitBoard, MoveGenerator::DIR_COUNT>, BitBoard::SIZE> lRayList;
+    };
+
+    const Tables& GetTables()
+    {
+        static const Tables mTables;
+        return mTables;
+    }
+
+    /// See MoveGenerator::GetJumpLanding().
+    /** \param pDependencies If not null, receives all the slots whose occupancy was looked at
+    */
+    inline uint_t GetJumpLanding(const Tables& mTables, const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin,
+        uint_t d, BitBoard* pDependencies)
+    {
+        const BitBoard& mRay = mTables.lRayList[uiIndex][d];
+
+        BitBoard mBlockers = mRay & mOccupied;
+        if (mBlockers.IsEmpty())
+        {
+            if (pDependencies)
+                *pDependencies |= mRay;
+            return npos;
+        }
+
+        // The orb we jump over is the closest one in this direction
+        int iOffset = GetOffset(d);
+        uint_t uiPivot = iOffset > 0 ? mBlockers.GetFirst() : mBlockers.GetLast();
+        if (pDependencies)
+            *pDependencies |= mRay & ~mTables.lRayList[uiPivot][d];
+
+        if (uiPivot == uiOrigin)
+            return npos;
+
+        // We land as far behind it as we were in front of it
+        int iLanding = 2*int(uiPivot) - int(uiIndex);
+        if (iLanding < 0 || iLanding >= int(BitBoard::SIZE) || !mRay.Test(iLanding))
+            return npos;
+
+        // ... and all the slots in between must be free
+        BitBoard mBehind = mTables.lRayList[uiPivot][d] & ~mTables.lRayList[iLanding][d];
+        if (pDependencies)
+            *pDependencies |= mBehind;
+
+        if (!(mBehind & mOccupied).IsEmpty())
+            return npos;
+
+        return uint_t(iLanding);
+    }
+
+    /// See MoveGenerator::GetJumps().
+    /** \param pDependencies If not null, receives all the slots whose occupancy was looked at
+    */
+    BitBoard GetJumps(const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin, BitBoard* pDependencies)
+    {
+        const Tables& mTables = GetTables();
+
+        BitBoard mJumps;
+        for (uint_t d = 0; d < MoveGenerator::DIR_COUNT; ++d)
+        {
+            uint_t uiLanding = GetJumpLanding(mTables, mOccupied, uiIndex, uiOrigin, d, pDependencies);
+            if (uiLanding != npos)
+                mJumps.Set(uiLanding);
+        }
+
+        return mJumps;
+    }
+
+    /// See MoveGenerator::GetMovements().
+    BitBoard GetMovements(const BitBoard& mOccupied, uint_t uiIndex, BitBoard* pDependencies)
+    {
+        const BitBoard& mNeighbors = GetTables().lNeighborList[uiIndex];
+        if (pDependencies)
+            *pDependencies = mNeighbors;
+
+        BitBoard mMovements = mNeighbors & ~mOccupied;
+        BitBoard mVisited = mMovements;
+        mVisited.Set(uiIndex);
+
+        // Chain jumps, one level at a time
+        BitBoard mFront = GetJumps(mOccupied, uiIndex, uiIndex, pDependencies) & ~mVisited;
+        while (!mFront.IsEmpty())
+        {
+            mVisited |= mFront;
+            mMovements |= mFront;
+
+            BitBoard mNext;
+            while (!mFront.IsEmpty())
+                mNext |= GetJumps(mOccupied, mFront.PopFirst(), uiIndex, pDependencies);
+
+            mFront = mNext & ~mVisited;
+        }
+
+        return mMovements;
+    }
+}
+
+const BitBoard& MoveGenerator::GetBoardMask()
+{
+    return GetTables().mBoard;
+}
+
+bool MoveGenerator::IsOnBoard(const Slot& mSlot)
+{
+    if (!IsInRange(mSlot.X(), 0, BitBoard::WIDTH - 1) || !IsInRange(mSlot.Y(), 0, BitBoard::WIDTH - 1))
+        return false;
+
+    return GetTables().mBoard.Test(BitBoard::GetIndex(mSlot));
+}
+
+const BitBoard& MoveGenerator::GetHomeMask(uint_t uiHome)
+{
+    return GetTables().lHomeList[uiHome];
+}
+
+const BitBoard& MoveGenerator::GetNeighbors(uint_t uiIndex)
+{
+    return GetTables().lNeighborList[uiIndex];
+}
+
+const BitBoard& MoveGenerator::GetRay(uint_t uiIndex, uint_t uiDirection)
+{
+    return GetTables().lRayList[uiIndex][uiDirection];
+}
+
+BitBoard MoveGenerator::Shift(const BitBoard& mBoard, uint_t uiDirection)
+{
+    return GetTables().Shift(mBoard, uiDirection);
+}
+
+BitBoard MoveGenerator::GetJumps(const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin)
+{
+    return ::GetJumps(mOccupied, uiIndex, uiOrigin, nullptr);
+}
+
+uint_t MoveGenerator::GetJumpLanding(const BitBoard& mOccupied, uint_t uiIndex, uint_t uiOrigin, uint_t uiDirection)
+{
+    return ::GetJumpLanding(GetTables(), mOccupied, uiIndex, uiOrigin, uiDirection, nullptr);
+}
+
+bool MoveGenerator::GetJumpPath(const BitBoard& mOccupied, uint_t uiFrom, uint_t uiTo, std::vector<uchar_t>& lDirections)
+{
+    lDirections.clear();
+
+    const Tables& mTables = GetTables();
+
+    // Breadth first search over the jumps, remembering where we came from
+    std::array<uchar_t, BitBoard::SIZE> lParentList;
+    std::array<uchar_t, BitBoard::SIZE> lDirectionList;
+
+    BitBoard mVisited = BitBoard::FromIndex(uiFrom);
+    BitBoard mFront = mVisited;
+    while (!mFront.IsEmpty() && !mVisited.Test(uiTo))
+    {
+        BitBoard mNext;
+        while (!mFront.IsEmpty())
+        {
+            uint_t uiIndex = mFront.PopFirst();
+            for (uint_t d = 0; d < DIR_COUNT; ++d)
+            {
+                uint_t uiLanding = ::GetJumpLanding(mTables, mOccupied, uiIndex, uiFrom, d, nullptr);
+                if (uiLanding == npos || mVisited.Test(uiLanding) || mNext.Test(uiLanding))
+                    continue;
+
+                lParentList[uiLanding] = uchar_t(uiIndex);
+                lDirectionList[uiLanding] = uchar_t(d);
+                mNext.Set(uiLanding);
+            }
+        }
+
+        mVisited |= mNext;
+        mFront = mNext;
+    }
+
+    if (uiFrom == uiTo || !mVisited.Test(uiTo))
+        return false;
+
+    for (uint_t uiIndex = uiTo; uiIndex != uiFrom; uiIndex = lParentList[uiIndex])
+        lDirections.push_back(lDirectionList[uiIndex]);
+
+    std::reverse(lDirections.begin(), lDirections.end());
+    return true;
+}
+
+BitBoard MoveGenerator::GetMovements(const BitBoard& mOccupied, uint_t uiIndex)
+{
+    return ::GetMovements(mOccupied, uiIndex, nullptr);
+}
+
+BitBoard MoveGenerator::GetMovements(const BitBoard& mOccupied, uint_t uiIndex, BitBoard& mDependencies)
+{
+    return ::GetMovements(mOccupied, uiIndex, &mDependencies);
+}
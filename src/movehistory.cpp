@@ -0,0 +1,168 @@
+#include "movehistory.h"
+#include "movegenerator.h"
+
+namespace
+{
+    const uchar_t JUMP_FLAG = 0x80;
+    const uint_t  JUMP_BITS = 3;
+}
+
+MoveHistory::MoveHistory()
+{
+    Clear();
+}
+
+void MoveHistory::Clear()
+{
+    lData_.clear();
+    lSnapshotList_.clear();
+    mLastPosition_.Reset();
+    uiSize_ = 0;
+
+    lSnapshotList_.push_back(Snapshot_());
+}
+
+bool MoveHistory::Push(const Move& mMove)
+{
+    if (mLastPosition_.IsOver())
+        return false;
+
+    std::vector<uchar_t> lJumpList;
+    if (mMove != Move())
+    {
+        uint_t uiOrb = mLastPosition_.GetOrbAt(uint_t(mMove.uiFrom));
+        if (uiOrb == npos || !mLastPosition_.CanPlay(uiOrb) || !mLastPosition_.GetMovements(uiOrb).Test(mMove.uiTo))
+            return false;
+
+        // Single steps need no path
+        if (!MoveGenerator::GetNeighbors(mMove.uiFrom).Test(mMove.uiTo))
+            MoveGenerator::GetJumpPath(mLastPosition_.GetOccupied(), mMove.uiFrom, mMove.uiTo, lJumpList);
+    }
+
+    lData_.push_back(mMove.uiFrom | (lJumpList.empty() ? 0 : JUMP_FLAG));
+    lData_.push_back(mMove.uiTo);
+
+    if (!lJumpList.empty())
+    {
+        lData_.push_back(uchar_t(lJumpList.size()));
+
+        // Pack the directions, 3 bits each
+        uint_t uiStart = lData_.size();
+        lData_.resize(uiStart + (JUMP_BITS*lJumpList.size() + 7)/8, 0);
+        for (uint_t i = 0; i < lJumpList.size(); ++i)
+        {
+            uint_t uiBit = JUMP_BITS*i;
+            uint_t uiValue = uint_t(lJumpList[i]) << (uiBit % 8);
+            lData_[uiStart + uiBit/8] |= uchar_t(uiValue);
+            if (uiValue > 0xFF)
+                lData_[uiStart + uiBit/8 + 1] |= uchar_t(uiValue >> 8);
+        }
+    }
+
+    Play_(mLastPosition_, mMove);
+    ++uiSize_;
+
+    if (uiSize_ % SNAPSHOT_INTERVAL == 0)
+    {
+        Snapshot_ mSnapshot;
+        mSnapshot.mGame = mLastPosition_;
+        mSnapshot.uiOffset = lData_.size();
+        lSnapshotList_.push_back(mSnapshot);
+    }
+
+    return true;
+}
+
+uint_t MoveHistory::GetSize() const
+{
+    return uiSize_;
+}
+
+uint_t MoveHistory::GetDataSize() const
+{
+    return lData_.size();
+}
+
+uint_t MoveHistory::Decode_(uint_t uiOffset, Move& mMove, std::vector<uchar_t>* pJumpList) const
+{
+    uchar_t uiFrom = lData_[uiOffset++];
+    mMove.uiFrom = uiFrom & ~JUMP_FLAG;
+    mMove.uiTo = lData_[uiOffset++];
+
+    if (pJumpList)
+        pJumpList->clear();
+
+    if (!(uiFrom & JUMP_FLAG))
+        return uiOffset;
+
+    uint_t uiCount = lData_[uiOffset++];
+    if (pJumpList)
+    {
+        for (uint_t i = 0; i < uiCount; ++i)
+        {
+            uint_t uiBit = JUMP_BITS*i;
+            uint_t uiValue = lData_[uiOffset + uiBit/8] >> (uiBit % 8);
+            if (uiBit % 8 > 8 - JUMP_BITS)
+                uiValue |= uint_t(lData_[uiOffset + uiBit/8 + 1]) << (8 - uiBit % 8);
+
+            pJumpList->push_back(uchar_t(uiValue & ((1 << JUMP_BITS) - 1)));
+        }
+    }
+
+    return uiOffset + (JUMP_BITS*uiCount + 7)/8;
+}
+
+MoveHistory::Turn MoveHistory::GetTurn(uint_t uiPly) const
+{
+    Turn mTurn;
+    if (uiPly >= uiSize_)
+        return mTurn;
+
+    // Start from the closest snapshot, and skip the turns in between
+    uint_t uiOffset = lSnapshotList_[uiPly / SNAPSHOT_INTERVAL].uiOffset;
+    for (uint_t i = uiPly - uiPly % SNAPSHOT_INTERVAL; i < uiPly; ++i)
+        uiOffset = Decode_(uiOffset, mTurn.mMove, nullptr);
+
+    Decode_(uiOffset, mTurn.mMove, &mTurn.lJumpList);
+    return mTurn;
+}
+
+std::vector<Move> MoveHistory::GetMoveList() const
+{
+    std::vector<Move> lMoveList(uiSize_);
+
+    uint_t uiOffset = 0;
+    for (auto& mMove : lMoveList)
+        uiOffset = Decode_(uiOffset, mMove, nullptr);
+
+    return lMoveList;
+}
+
+void MoveHistory::GetPosition(uint_t uiPly, GameState& mGame) const
+{
+    uiPly = std::min(uiPly, uiSize_);
+
+    const Snapshot_& mSnapshot = lSnapshotList_[uiPly / SNAPSHOT_INTERVAL];
+    mGame = mSnapshot.mGame;
+
+    Move mMove;
+    uint_t uiOffset = mSnapshot.uiOffset;
+    for (uint_t i = uiPly - uiPly % SNAPSHOT_INTERVAL; i < uiPly; ++i)
+    {
+        uiOffset = Decode_(uiOffset, mMove, nullptr);
+        Play_(mGame, mMove);
+    }
+}
+
+const GameState& MoveHistory::GetLastPosition() const
+{
+    return mLastPosition_;
+}
+
+void MoveHistory::Play_(GameState& mGame, const Move& mMove)
+{
+    if (mMove == Move())
+        mGame.EndTurn();
+    else
+        mGame.PlayMove(mMove);
+}
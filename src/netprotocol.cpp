@@ -0,0 +1,82 @@
+#include "netprotocol.h"
+
+#include <algorithm>
+
+namespace
+{
+    const uchar_t NET_MAGIC[3] = {'O', 'R', 'B'};
+}
+
+void NetProtocol::Write(const NetMessage& mMessage, std::vector<uchar_t>& lBuffer)
+{
+    uchar_t lData[MAX_MESSAGE_SIZE];
+    uint_t uiSize = Write(mMessage, lData);
+    lBuffer.insert(lBuffer.end(), lData, lData + uiSize);
+}
+
+uint_t NetProtocol::Write(const NetMessage& mMessage, uchar_t* pBuffer)
+{
+    pBuffer[0] = uchar_t(mMessage.mType);
+
+    switch (mMessage.mType)
+    {
+        case NetMessage::TYPE_HELLO :
+            std::copy(NET_MAGIC, NET_MAGIC + 3, pBuffer + 1);
+            pBuffer[4] = uchar_t(VERSION);
+            pBuffer[5] = uchar_t(mMessage.uiPlayer);
+            return 6;
+        case NetMessage::TYPE_MOVE :
+            // Little endian, like the save files
+            pBuffer[1] = uchar_t(mMessage.uiPly & 0xFF);
+            pBuffer[2] = uchar_t((mMessage.uiPly >> 8) & 0xFF);
+            pBuffer[3] = mMessage.mMove.uiFrom;
+            pBuffer[4] = mMessage.mMove.uiTo;
+            return 5;
+        case NetMessage::TYPE_BYE :
+            return 1;
+    }
+
+    return 1;
+}
+
+uint_t NetProtocol::Read(const uchar_t* pData, uint_t uiSize, NetMessage& mMessage)
+{
+    if (uiSize == 0)
+        return 0;
+
+    uint_t uiMessageSize;
+    switch (pData[0])
+    {
+        case NetMessage::TYPE_HELLO : uiMessageSize = 6; break;
+        case NetMessage::TYPE_MOVE :  uiMessageSize = 5; break;
+        case NetMessage::TYPE_BYE :   uiMessageSize = 1; break;
+        default : return npos;
+    }
+
+    if (uiSize < uiMessageSize)
+        return 0;
+
+    NetMessage mNewMessage;
+    mNewMessage.mType = (NetMessage::Type)pData[0];
+
+    switch (mNewMessage.mType)
+    {
+        case NetMessage::TYPE_HELLO :
+            if (!std::equal(NET_MAGIC, NET_MAGIC + 3, pData + 1) || pData[4] != VERSION || pData[5] > 1)
+                return npos;
+
+            mNewMessage.uiPlayer = pData[5];
+            break;
+        case NetMessage::TYPE_MOVE :
+            mNewMessage.uiPly = pData[1] | (uint_t(pData[2]) << 8);
+            mNewMessage.mMove = Move(pData[3], pData[4]);
+            if (mNewMessage.mMove.uiFrom >= BitBoard::SIZE || mNewMessage.mMove.uiTo >= BitBoard::SIZE)
+                return npos;
+            break;
+        case NetMessage::TYPE_BYE :
+            break;
+    }
+
+    mMessage = mNewMessage;
+    return uiMessageSize;
+}
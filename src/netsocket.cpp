@@ -0,0 +1,74 @@
+#include "netsocket.h"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+int OpenListenSocket(unsigned short uiPort)
+{
+    int iSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (iSocket < 0)
+        return -1;
+
+    int iEnable = 1;
+    setsockopt(iSocket, SOL_SOCKET, SO_REUSEADDR, &iEnable, sizeof(iEnable));
+
+    sockaddr_in mAddress;
+    std::memset(&mAddress, 0, sizeof(mAddress));
+    mAddress.sin_family = AF_INET;
+    mAddress.sin_port = htons(uiPort);
+    mAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(iSocket, reinterpret_cast<sockaddr*>(&mAddress), sizeof(mAddress)) != 0 ||
+        listen(iSocket, SOMAXCONN) != 0 || !SetSocketOptions(iSocket))
+    {
+        close(iSocket);
+        return -1;
+    }
+
+    return iSocket;
+}
+
+int ConnectSocket(const std::string& sAddress, unsigned short uiPort)
+{
+    addrinfo mHints;
+    std::memset(&mHints, 0, sizeof(mHints));
+    mHints.ai_family = AF_INET;
+    mHints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* pResult = nullptr;
+    if (getaddrinfo(sAddress.c_str(), ToString(uiPort).c_str(), &mHints, &pResult) != 0)
+        return -1;
+
+    int iSocket = socket(pResult->ai_family, pResult->ai_socktype, pResult->ai_protocol);
+    if (iSocket >= 0 && connect(iSocket, pResult->ai_addr, pResult->ai_addrlen) != 0)
+    {
+        close(iSocket);
+        iSocket = -1;
+    }
+
+    freeaddrinfo(pResult);
+    return iSocket;
+}
+
+bool SetSocketOptions(int iSocket)
+{
+    int iFlags = fcntl(iSocket, F_GETFL, 0);
+    if (iFlags < 0 || fcntl(iSocket, F_SETFL, iFlags | O_NONBLOCK) < 0)
+        return false;
+
+    // Turns are a few bytes : don't wait to fill a packet (fails on listening sockets)
+    int iEnable = 1;
+    setsockopt(iSocket, IPPROTO_TCP, TCP_NODELAY, &iEnable, sizeof(iEnable));
+    return true;
+}
+
+void CloseSocket(int iSocket)
+{
+    if (iSocket >= 0)
+        close(iSocket);
+}
@@ -0,0 +1,262 @@
+#include "networkplayer.h"
+#include "log.h"
+
+#include <thread>
+
+const std::string NetworkPlayer::CLASS_NAME = "NetworkPlayer";
+
+namespace
+{
+    const float CONNECT_TIMEOUT = 5.0f;
+}
+
+NetworkPlayer::NetworkPlayer()
+{
+}
+
+NetworkPlayer::~NetworkPlayer()
+{
+    Close();
+}
+
+bool NetworkPlayer::Host(unsigned short uiPort)
+{
+    Close();
+
+    if (mListener_.listen(uiPort) != sf::Socket::Done)
+    {
+        Error(CLASS_NAME, "Cannot listen to port "+ToString(uiPort)+".");
+        mState_ = STATE_CLOSED;
+        return false;
+    }
+
+    mListener_.setBlocking(false);
+    pConnection_ = std::make_shared<Connection_>();
+    pConnection_->bDone = false;
+
+    uiLocalPlayer_ = 0;
+    mState_ = STATE_LISTENING;
+    Log("Waiting for a player on port "+ToString(uiPort)+"...");
+    return true;
+}
+
+void NetworkPlayer::Join(const std::string& sAddress, unsigned short uiPort)
+{
+    Close();
+
+    pConnection_ = std::make_shared<Connection_>();
+    pConnection_->bDone = false;
+
+    // If the connection is closed before the host answers, the thread
+    // keeps its own reference and finishes alone
+    std::shared_ptr<Connection_> pConnection = pConnection_;
+    std::thread([pConnection, sAddress, uiPort]() {
+        pConnection->mStatus = pConnection->mSocket.connect(sf::IpAddress(sAddress), uiPort, sf::seconds(CONNECT_TIMEOUT));
+        pConnection->bDone = true;
+    }).detach();
+
+    uiLocalPlayer_ = 1;
+    mState_ = STATE_CONNECTING;
+    Log("Connecting to "+sAddress+":"+ToString(uiPort)+"...");
+}
+
+void NetworkPlayer::Close()
+{
+    if (mState_ == STATE_HANDSHAKE || mState_ == STATE_READY)
+    {
+        // Best effort : the other side also notices the disconnection
+        NetMessage mMessage;
+        mMessage.mType = NetMessage::TYPE_BYE;
+        NetProtocol::Write(mMessage, lOutBuffer_);
+        Send_();
+
+        pConnection_->mSocket.disconnect();
+    }
+
+    mListener_.close();
+    pConnection_ = nullptr;
+
+    lInBuffer_.clear();
+    lOutBuffer_.clear();
+    lMoveList_.clear();
+
+    if (mState_ != STATE_IDLE)
+        mState_ = STATE_CLOSED;
+}
+
+void NetworkPlayer::Update()
+{
+    switch (mState_)
+    {
+        case STATE_LISTENING :
+            if (mListener_.accept(pConnection_->mSocket) == sf::Socket::Done)
+            {
+                mListener_.close();
+                OnConnected_();
+            }
+            break;
+        case STATE_CONNECTING :
+            if (pConnection_->bDone)
+            {
+                if (pConnection_->mStatus == sf::Socket::Done)
+                    OnConnected_();
+                else
+                    Fail_("Cannot connect to the host.");
+            }
+            break;
+        case STATE_HANDSHAKE :
+        case STATE_READY :
+            Receive_();
+            Send_();
+            break;
+        case STATE_IDLE :
+        case STATE_CLOSED :
+            break;
+    }
+}
+
+void NetworkPlayer::OnConnected_()
+{
+    pConnection_->mSocket.setBlocking(false);
+    mState_ = STATE_HANDSHAKE;
+
+    Log("Connected to "+pConnection_->mSocket.getRemoteAddress().toString()+".");
+
+    NetMessage mMessage;
+    mMessage.mType = NetMessage::TYPE_HELLO;
+    mMessage.uiPlayer = uiLocalPlayer_;
+    NetProtocol::Write(mMessage, lOutBuffer_);
+    Send_();
+}
+
+void NetworkPlayer::Receive_()
+{
+    uchar_t lData[256];
+    bool bLost = false;
+    for (;;)
+    {
+        std::size_t uiReceived = 0;
+        sf::Socket::Status mStatus = pConnection_->mSocket.receive(lData, sizeof(lData), uiReceived);
+        if (mStatus == sf::Socket::Done)
+            lInBuffer_.insert(lInBuffer_.end(), lData, lData + uiReceived);
+        else
+        {
+            // Read what was received before the disconnection (it may be a BYE)
+            bLost = mStatus != sf::Socket::NotReady;
+            break;
+        }
+    }
+
+    uint_t uiOffset = 0;
+    while (mState_ == STATE_HANDSHAKE || mState_ == STATE_READY)
+    {
+        NetMessage mMessage;
+        uint_t uiSize = NetProtocol::Read(lInBuffer_.data() + uiOffset, lInBuffer_.size() - uiOffset, mMessage);
+        if (uiSize == 0)
+            break;
+
+        if (uiSize == npos)
+        {
+            Fail_("Received an invalid message.");
+            return;
+        }
+
+        uiOffset += uiSize;
+
+        switch (mMessage.mType)
+        {
+            case NetMessage::TYPE_HELLO :
+                if (mState_ != STATE_HANDSHAKE || mMessage.uiPlayer == uiLocalPlayer_)
+                {
+                    Fail_("The other game doesn't follow the protocol.");
+                    return;
+                }
+                mState_ = STATE_READY;
+                break;
+            case NetMessage::TYPE_MOVE :
+                if (mState_ != STATE_READY)
+                {
+                    Fail_("The other game doesn't follow the protocol.");
+                    return;
+                }
+                lMoveList_.push_back(mMessage);
+                break;
+            case NetMessage::TYPE_BYE :
+                Log("The other player left the game.");
+                pConnection_->mSocket.disconnect();
+                mState_ = STATE_CLOSED;
+                break;
+        }
+    }
+
+    if (mState_ == STATE_HANDSHAKE || mState_ == STATE_READY)
+    {
+        lInBuffer_.erase(lInBuffer_.begin(), lInBuffer_.begin() + uiOffset);
+
+        if (bLost)
+            Fail_("The connection was lost.");
+    }
+}
+
+void NetworkPlayer::Send_()
+{
+    while (!lOutBuffer_.empty())
+    {
+        std::size_t uiSent = 0;
+        sf::Socket::Status mStatus = pConnection_->mSocket.send(lOutBuffer_.data(), lOutBuffer_.size(), uiSent);
+        lOutBuffer_.erase(lOutBuffer_.begin(), lOutBuffer_.begin() + uiSent);
+
+        if (mStatus == sf::Socket::NotReady || mStatus == sf::Socket::Partial)
+            break;
+        else if (mStatus != sf::Socket::Done)
+        {
+            lOutBuffer_.clear();
+            Fail_("The connection was lost.");
+            return;
+        }
+    }
+}
+
+void NetworkPlayer::Fail_(const std::string& sMessage)
+{
+    Warning(CLASS_NAME, sMessage);
+
+    if (pConnection_)
+        pConnection_->mSocket.disconnect();
+
+    mListener_.close();
+    mState_ = STATE_CLOSED;
+}
+
+NetworkPlayer::State NetworkPlayer::GetState() const
+{
+    return mState_;
+}
+
+uint_t NetworkPlayer::GetLocalPlayer() const
+{
+    return uiLocalPlayer_;
+}
+
+void NetworkPlayer::SendMove(uint_t uiPly, const Move& mMove)
+{
+    if (mState_ != STATE_READY)
+        return;
+
+    NetMessage mMessage;
+    mMessage.mType = NetMessage::TYPE_MOVE;
+    mMessage.uiPly = uiPly;
+    mMessage.mMove = mMove;
+    NetProtocol::Write(mMessage, lOutBuffer_);
+    Send_();
+}
+
+bool NetworkPlayer::PopMove(NetMessage& mMessage)
+{
+    if (lMoveList_.empty())
+        return false;
+
+    mMessage = lMoveList_.front();
+    lMoveList_.pop_front();
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "orb.h"
 #include "sprite.h"
+#include "spritebatch.h"
 
 Orb::Orb(const Vector2D& mPos, const Slot& mSlot, Type mType) :
     mPosition_(mPos), mTempPosition_(mPos), mSlot_(mSlot), mType_(mType)
@@ -51,23 +52,26 @@ const Vector2D& Orb::GetPosition() const
     return mPosition_;
 }
 
-void Orb::Render() const
+void Orb::RenderMovements(SpriteBatch& mBatch) const
 {
-    if (bMouseOver_)
+    if (!bMouseOver_)
+        return;
+
+    for (auto& mAvailableSlot : lAvailableMovements_)
     {
-        for (auto& mAvailableSlot : lAvailableMovements_)
+        if (!IsOnSlot(mAvailableSlot))
         {
-            if (!IsOnSlot(mAvailableSlot))
-            {
-                pMovementSprite_->Render(
-                    float(mAvailableSlot.X()*64) + mPosition_.X() - 64.0f*float(mSlot_.X()),
-                    float(mAvailableSlot.Y()*64) + mPosition_.Y() - 64.0f*float(mSlot_.Y())
-                );
-            }
+            pMovementSprite_->Render(mBatch,
+                float(mAvailableSlot.X()*64) + mPosition_.X() - 64.0f*float(mSlot_.X()),
+                float(mAvailableSlot.Y()*64) + mPosition_.Y() - 64.0f*float(mSlot_.Y())
+            );
         }
     }
+}
 
-    pSprite_->Render(mTempPosition_.X(), mTempPosition_.Y());
+void Orb::Render(SpriteBatch& mBatch) const
+{
+    pSprite_->Render(mBatch, mTempPosition_.X(), mTempPosition_.Y());
 }
 
 bool Orb::Contains(const Vector2D& mPos) const
@@ -0,0 +1,108 @@
+#include "gamestate.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    struct PerftResult
+    {
+        uint64_t uiNodes = 0;
+        uint64_t uiChecksum = 0;
+    };
+
+    /// Counts the leaves of the game tree, and sums their Zobrist hash.
+    /** \note lMoveStack holds one move list per ply, to avoid allocations.
+    */
+    void Perft(GameState& mGame, uint_t uiDepth, std::vector< std::vector<Move> >& lMoveStack, PerftResult& mResult)
+    {
+        if (uiDepth == 0 || mGame.IsOver())
+        {
+            ++mResult.uiNodes;
+            mResult.uiChecksum += mGame.GetHash();
+            return;
+        }
+
+        std::vector<Move>& lMoveList = lMoveStack[uiDepth - 1];
+        mGame.GenerateMoves(lMoveList);
+
+        for (auto& mMove : lMoveList)
+        {
+            mGame.PlayMove(mMove);
+            Perft(mGame, uiDepth - 1, lMoveStack, mResult);
+            mGame.UndoMove(mMove);
+        }
+    }
+
+    std::string ToHex(uint64_t uiValue)
+    {
+        std::ostringstream ss;
+        ss << "0x" << std::hex << std::setw(16) << std::setfill('0') << uiValue;
+        return ss.str();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint_t uiMaxDepth = 4;
+    bool bDivide = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--divide") == 0)
+            bDivide = true;
+        else if (std::atoi(argv[i]) > 0)
+            uiMaxDepth = std::atoi(argv[i]);
+        else
+        {
+            std::cout << "Usage : orb_perft [depth] [--divide]" << std::endl;
+            return 1;
+        }
+    }
+
+    GameState mGame;
+    std::vector< std::vector<Move> > lMoveStack(uiMaxDepth);
+
+    std::cout << "Perft from the initial layout, up to depth " << uiMaxDepth << std::endl;
+
+    for (uint_t uiDepth = 1; uiDepth <= uiMaxDepth; ++uiDepth)
+    {
+        PerftResult mResult;
+
+        auto mStart = std::chrono::steady_clock::now();
+        Perft(mGame, uiDepth, lMoveStack, mResult);
+        double dTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+
+        std::cout << "depth " << std::setw(2) << uiDepth
+            << " : " << std::setw(14) << mResult.uiNodes << " nodes, "
+            << std::fixed << std::setprecision(3) << dTime << " s, "
+            << std::setprecision(0) << (dTime > 0.0 ? mResult.uiNodes/dTime : 0.0) << " nodes/s, "
+            << "checksum " << ToHex(mResult.uiChecksum) << std::endl;
+    }
+
+    if (bDivide)
+    {
+        // Break down the last depth by root move
+        std::vector<Move> lRootMoves;
+        mGame.GenerateMoves(lRootMoves);
+
+        std::cout << std::endl << "Divide at depth " << uiMaxDepth << " :" << std::endl;
+        for (auto& mMove : lRootMoves)
+        {
+            PerftResult mResult;
+            mGame.PlayMove(mMove);
+            Perft(mGame, uiMaxDepth - 1, lMoveStack, mResult);
+            mGame.UndoMove(mMove);
+
+            Slot mFrom = BitBoard::GetSlot(mMove.uiFrom);
+            Slot mTo = BitBoard::GetSlot(mMove.uiTo);
+            std::cout << "(" << mFrom.X() << "," << mFrom.Y() << ") -> ("
+                << mTo.X() << "," << mTo.Y() << ") : " << mResult.uiNodes << std::endl;
+        }
+    }
+
+    return 0;
+}
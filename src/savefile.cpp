@@ -0,0 +1,225 @@
+#include "savefile.h"
+#include "mappedfile.h"
+#include "log.h"
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+const std::string SaveFile::CLASS_NAME = "SaveFile";
+
+namespace
+{
+    const char     SAVE_MAGIC[4] = {'O', 'R', 'B', 'S'};
+    const uint_t   HEADER_SIZE = 4 + 3*sizeof(uint32_t);
+    const uchar_t  NO_ORB = 0xFF;
+
+    uint32_t ComputeCRC32(const uchar_t* pData, uint_t uiSize)
+    {
+        static const std::array<uint32_t, 256> lTable = []() {
+            std::array<uint32_t, 256> lTable;
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t uiValue = i;
+                for (uint_t j = 0; j < 8; ++j)
+                    uiValue = (uiValue & 1) ? (0xEDB88320u ^ (uiValue >> 1)) : (uiValue >> 1);
+
+                lTable[i] = uiValue;
+            }
+            return lTable;
+        }();
+
+        uint32_t uiCRC = 0xFFFFFFFFu;
+        for (uint_t i = 0; i < uiSize; ++i)
+            uiCRC = lTable[(uiCRC ^ pData[i]) & 0xFF] ^ (uiCRC >> 8);
+
+        return uiCRC ^ 0xFFFFFFFFu;
+    }
+
+    template<typename T>
+    void Append(std::vector<uchar_t>& lBuffer, const T& mValue)
+    {
+        const uchar_t* pValue = reinterpret_cast<const uchar_t*>(&mValue);
+        lBuffer.insert(lBuffer.end(), pValue, pValue + sizeof(T));
+    }
+
+    enum HeaderStatus
+    {
+        HEADER_OK,
+        HEADER_INVALID,
+        HEADER_VERSION,
+        HEADER_CORRUPTED
+    };
+
+    /// Checks the header and the CRC, and moves pData to the content.
+    HeaderStatus CheckHeader(const uchar_t*& pData, const uchar_t* pEnd, uint32_t& uiVersion)
+    {
+        uint32_t lHeader[3];
+        if (uint_t(pEnd - pData) < HEADER_SIZE || std::memcmp(pData, SAVE_MAGIC, 4) != 0)
+            return HEADER_INVALID;
+
+        std::memcpy(lHeader, pData + 4, sizeof(lHeader));
+        pData += HEADER_SIZE;
+
+        uiVersion = lHeader[0];
+        if (uiVersion != SaveFile::VERSION)
+            return HEADER_VERSION;
+
+        if (lHeader[1] != uint_t(pEnd - pData) || lHeader[2] != ComputeCRC32(pData, lHeader[1]))
+            return HEADER_CORRUPTED;
+
+        return HEADER_OK;
+    }
+
+    template<typename T>
+    bool Extract(const uchar_t*& pData, const uchar_t* pEnd, T& mValue)
+    {
+        if (uint_t(pEnd - pData) < sizeof(T))
+            return false;
+
+        std::memcpy(&mValue, pData, sizeof(T));
+        pData += sizeof(T);
+        return true;
+    }
+}
+
+bool SaveFile::Write(const std::string& sFile, const SaveData& mData)
+{
+    const GameState& mGame = mData.mGame;
+
+    std::vector<uchar_t> lContent;
+    lContent.reserve(64 + mData.sName.size() + 2*mData.lHistory.size());
+
+    Append(lContent, uint32_t(mData.sName.size()));
+    lContent.insert(lContent.end(), mData.sName.begin(), mData.sName.end());
+
+    Append(lContent, uchar_t(mData.uiOpponent));
+    Append(lContent, uchar_t(mGame.GetState()));
+
+    uint_t uiMovedOrb = mGame.GetMovedOrb();
+    Append(lContent, uchar_t(uiMovedOrb == npos ? NO_ORB : uiMovedOrb));
+    Append(lContent, uchar_t(uiMovedOrb == npos ? 0 : BitBoard::GetIndex(mGame.GetInitialSlot())));
+
+    for (uint_t i = 0; i < GameState::ORB_COUNT; ++i)
+        Append(lContent, uchar_t(mGame.GetOrbIndex(i)));
+
+    Append(lContent, uint32_t(mData.lHistory.size()));
+    for (auto& mMove : mData.lHistory)
+    {
+        Append(lContent, mMove.uiFrom);
+        Append(lContent, mMove.uiTo);
+    }
+
+    std::string sTempFile = sFile + ".tmp";
+    std::ofstream mFile(sTempFile, std::ios::binary);
+    if (!mFile.is_open())
+    {
+        Error(CLASS_NAME, "Cannot open \""+sTempFile+"\" for writing.");
+        return false;
+    }
+
+    uint32_t lHeader[3] = {VERSION, uint32_t(lContent.size()), ComputeCRC32(lContent.data(), lContent.size())};
+    mFile.write(SAVE_MAGIC, 4);
+    mFile.write(reinterpret_cast<const char*>(lHeader), sizeof(lHeader));
+    mFile.write(reinterpret_cast<const char*>(lContent.data()), lContent.size());
+    mFile.close();
+
+    if (!mFile || !ReplaceFile(sTempFile, sFile))
+    {
+        std::remove(sTempFile.c_str());
+        Error(CLASS_NAME, "Cannot write \""+sFile+"\".");
+        return false;
+    }
+
+    return true;
+}
+
+bool SaveFile::Read(const std::string& sFile, SaveData& mData)
+{
+    MappedFile mFile;
+    if (!mFile.Open(sFile))
+        return false;
+
+    const uchar_t* pData = mFile.GetData();
+    const uchar_t* pEnd = pData + mFile.GetSize();
+
+    uint32_t uiVersion = 0;
+    switch (CheckHeader(pData, pEnd, uiVersion))
+    {
+    case HEADER_OK :
+        break;
+    case HEADER_INVALID :
+        Error(CLASS_NAME, "\""+sFile+"\" is not a saved game.");
+        return false;
+    case HEADER_VERSION :
+        Error(CLASS_NAME, "\""+sFile+"\" was saved with an unsupported version ("+ToString(uiVersion)+").");
+        return false;
+    case HEADER_CORRUPTED :
+        Error(CLASS_NAME, "\""+sFile+"\" is corrupted.");
+        return false;
+    }
+
+    SaveData mNewData;
+
+    uint32_t uiNameSize;
+    bool bValid = Extract(pData, pEnd, uiNameSize) && uiNameSize <= uint_t(pEnd - pData);
+    if (bValid)
+    {
+        mNewData.sName.assign(reinterpret_cast<const char*>(pData), uiNameSize);
+        pData += uiNameSize;
+    }
+
+    uchar_t uiOpponent = 0, uiState = 0, uiMovedOrb = 0, uiInitialSlot = 0;
+    std::array<uchar_t, GameState::ORB_COUNT> lOrbSlotList;
+    bValid = bValid && Extract(pData, pEnd, uiOpponent) && Extract(pData, pEnd, uiState) &&
+        Extract(pData, pEnd, uiMovedOrb) && Extract(pData, pEnd, uiInitialSlot) &&
+        Extract(pData, pEnd, lOrbSlotList);
+
+    uint32_t uiHistorySize = 0;
+    bValid = bValid && Extract(pData, pEnd, uiHistorySize) && uint_t(pEnd - pData) == 2*uint_t(uiHistorySize);
+
+    if (bValid)
+    {
+        mNewData.lHistory.resize(uiHistorySize);
+        for (auto& mMove : mNewData.lHistory)
+        {
+            mMove.uiFrom = *pData++;
+            mMove.uiTo = *pData++;
+        }
+    }
+
+    bValid = bValid && mNewData.mGame.SetLayout(lOrbSlotList, (GameState::State)uiState,
+        uiMovedOrb == NO_ORB ? npos : uiMovedOrb, uiInitialSlot);
+
+    if (!bValid)
+    {
+        Error(CLASS_NAME, "\""+sFile+"\" contains an invalid game.");
+        return false;
+    }
+
+    mNewData.uiOpponent = uiOpponent;
+    mData = std::move(mNewData);
+
+    return true;
+}
+
+bool SaveFile::ReadName(const std::string& sFile, std::string& sName)
+{
+    MappedFile mFile;
+    if (!mFile.Open(sFile))
+        return false;
+
+    const uchar_t* pData = mFile.GetData();
+    const uchar_t* pEnd = pData + mFile.GetSize();
+
+    uint32_t uiVersion = 0;
+    if (CheckHeader(pData, pEnd, uiVersion) != HEADER_OK)
+        return false;
+
+    uint32_t uiNameSize;
+    if (!Extract(pData, pEnd, uiNameSize) || uiNameSize > uint_t(pEnd - pData))
+        return false;
+
+    sName.assign(reinterpret_cast<const char*>(pData), uiNameSize);
+    return true;
+}
@@ -0,0 +1,80 @@
+#include "gameserver.h"
+#include "log.h"
+
+#include <algorithm>
+#include <iostream>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    GameServer* pServer = nullptr;
+
+    bool ParseLogLevel(const std::string& sLevel)
+    {
+        static const std::array<const char*, 5> lNameList = {{"trace", "debug", "info", "warning", "error"}};
+        for (uint_t i = 0; i < lNameList.size(); ++i)
+        {
+            if (sLevel == lNameList[i])
+            {
+                SetLogLevel((LogLevel)i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void OnSignal(int)
+    {
+        if (pServer)
+            pServer->Stop();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned short uiPort = NetProtocol::DEFAULT_PORT;
+    uint_t uiWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    float fReportPeriod = 5.0f;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            uiPort = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            uiWorkerCount = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+            fReportPeriod = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--log-level") == 0 && i + 1 < argc && ParseLogLevel(argv[i + 1]))
+            ++i;
+        else if (std::strcmp(argv[i], "--log-json") == 0 && i + 1 < argc && SetLogJSONFile(argv[i + 1]))
+            ++i;
+        else
+        {
+            std::cout << "Usage : orb_server [--port N] [--workers N] [--report seconds]\n"
+                "                  [--log-level trace|debug|info|warning|error] [--log-json file]" << std::endl;
+            return 1;
+        }
+    }
+
+    GameServer mServer(uiWorkerCount);
+    if (!mServer.Start(uiPort))
+        return 1;
+
+    pServer = &mServer;
+    std::signal(SIGINT, &OnSignal);
+    std::signal(SIGTERM, &OnSignal);
+
+    mServer.Run(fReportPeriod);
+
+    pServer = nullptr;
+
+    GameServer::Statistics mStatistics = mServer.GetStatistics();
+    Log("Stopped after "+ToString(mStatistics.uiMatches)+" matches, "+ToString(mStatistics.uiMoves)+" moves, "+
+        ToString(mStatistics.uiGames)+" games played, "+ToString(mStatistics.uiRejected)+" rejected.");
+
+    return 0;
+}
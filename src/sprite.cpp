@@ -1,5 +1,6 @@
 #include "sprite.h"
 #include "texturemanager.h"
+#include "spritebatch.h"
 #include "application.h"
 
 const std::string Sprite::CLASS_NAME = "Sprite";
@@ -14,20 +15,22 @@ Sprite::Sprite()
 
 Sprite::Sprite( const std::string& sTextureFile ) : sTextureFile_(sTextureFile)
 {
-    sf::Texture& mTexture = *TextureManager::GetSingleton()->LoadTexture(sTextureFile_);
-    mSprite_.setTexture(mTexture);
-    fTextureWidth_ = mTexture.getSize().x;
-    fTextureHeight_ = mTexture.getSize().y;
+    const TextureRegion& mRegion = TextureManager::GetSingleton()->LoadRegion(sTextureFile_);
+    mSprite_.setTexture(*mRegion.pTexture);
+    mSprite_.setTextureRect(mRegion.mRect);
+    fTextureWidth_ = mRegion.mRect.width;
+    fTextureHeight_ = mRegion.mRect.height;
     fWidth_ = fTextureWidth_;
     fHeight_ = fTextureHeight_;
 }
 
 Sprite::Sprite( const std::string& sTextureFile, float fWidth, float fHeight ) : sTextureFile_(sTextureFile)
 {
-    sf::Texture& mTexture = *TextureManager::GetSingleton()->LoadTexture(sTextureFile_);
-    mSprite_.setTexture(mTexture);
-    fTextureWidth_ = mTexture.getSize().x;
-    fTextureHeight_ = mTexture.getSize().y;
+    const TextureRegion& mRegion = TextureManager::GetSingleton()->LoadRegion(sTextureFile_);
+    mSprite_.setTexture(*mRegion.pTexture);
+    mSprite_.setTextureRect(mRegion.mRect);
+    fTextureWidth_ = mRegion.mRect.width;
+    fTextureHeight_ = mRegion.mRect.height;
     fWidth_ = fWidth;
     fHeight_ = fHeight;
     mSprite_.setScale(fWidth_/fTextureWidth_, fHeight_/fTextureHeight_);
@@ -46,7 +49,25 @@ Sprite::Sprite( const Color& mColor, float fWidth, float fHeight )
 void Sprite::Render( float fX, float fY ) const
 {
     mSprite_.setPosition(fX, fY);
-    Application::GetMainApp()->GetRenderWindow()->draw(mSprite_);
+    Application::GetMainApp()->Draw(mSprite_);
+}
+
+void Sprite::Render( SpriteBatch& mBatch, float fX, float fY ) const
+{
+    mSprite_.setPosition(fX, fY);
+
+    const sf::Transform& mTransform = mSprite_.getTransform();
+    const sf::IntRect& mRect = mSprite_.getTextureRect();
+    float fW = mRect.width, fH = mRect.height;
+    float fU = mRect.left, fV = mRect.top;
+
+    sf::Vertex lVertices[4];
+    lVertices[0] = sf::Vertex(mTransform.transformPoint(0.0f, 0.0f), mSprite_.getColor(), sf::Vector2f(fU,      fV));
+    lVertices[1] = sf::Vertex(mTransform.transformPoint(fW,   0.0f), mSprite_.getColor(), sf::Vector2f(fU + fW, fV));
+    lVertices[2] = sf::Vertex(mTransform.transformPoint(fW,   fH),   mSprite_.getColor(), sf::Vector2f(fU + fW, fV + fH));
+    lVertices[3] = sf::Vertex(mTransform.transformPoint(0.0f, fH),   mSprite_.getColor(), sf::Vector2f(fU,      fV + fH));
+
+    mBatch.AddQuad(mSprite_.getTexture(), lVertices);
 }
 
 void Sprite::RenderEx( float fX, float fY, float fRot, float fHScale, float fVScale ) const
@@ -54,7 +75,7 @@ void Sprite::RenderEx( float fX, float fY, float fRot, float fHScale, float fVSc
     mSprite_.setPosition(fX, fY);
     mSprite_.setScale(fHScale*fWidth_/fTextureWidth_, fVScale*fHeight_/fTextureHeight_);
     mSprite_.rotate(fRot*360.0);
-    Application::GetMainApp()->GetRenderWindow()->draw(mSprite_);
+    Application::GetMainApp()->Draw(mSprite_);
 }
 
 void Sprite::SetColor( const Color& mColor )
@@ -0,0 +1,49 @@
+#include "spritebatch.h"
+#include "sprite.h"
+#include "application.h"
+
+SpriteBatch::SpriteBatch()
+{
+}
+
+void SpriteBatch::Clear()
+{
+    lVertexList_.clear();
+    lSegmentList_.clear();
+}
+
+void SpriteBatch::Add(const Sprite& mSprite, float fX, float fY)
+{
+    mSprite.Render(*this, fX, fY);
+}
+
+void SpriteBatch::AddQuad(const sf::Texture* pTexture, const sf::Vertex* lVertices)
+{
+    // Start a new draw call only when the texture changes
+    if (lSegmentList_.empty() || lSegmentList_.back().pTexture != pTexture)
+    {
+        Segment_ mSegment;
+        mSegment.pTexture = pTexture;
+        mSegment.uiFirst = lVertexList_.size();
+        mSegment.uiCount = 0;
+        lSegmentList_.push_back(mSegment);
+    }
+
+    lVertexList_.insert(lVertexList_.end(), lVertices, lVertices + 4);
+    lSegmentList_.back().uiCount += 4;
+}
+
+bool SpriteBatch::IsEmpty() const
+{
+    return lVertexList_.empty();
+}
+
+void SpriteBatch::Render() const
+{
+    Application* pApp = Application::GetMainApp();
+    for (auto& mSegment : lSegmentList_)
+    {
+        pApp->Draw(&lVertexList_[mSegment.uiFirst], mSegment.uiCount, sf::Quads,
+            sf::RenderStates(mSegment.pTexture));
+    }
+}
@@ -15,7 +15,6 @@ Text::Text()
     fLineSpacing_ = 1.5f;
     fTracking_ = 0.0f;
     mColor_ = Color(255, 255, 255);
-    fX_ = fY_ = std::numeric_limits<float>::infinity();
 }
 
 Text::Text( const std::string& sFileName, float fSize )
@@ -28,7 +27,6 @@ Text::Text( const std::string& sFileName, float fSize )
     sFileName_ = sFileName;
     fSize_ = fSize;
     mColor_ = Color(255, 255, 255);
-    fX_ = fY_ = std::numeric_limits<float>::infinity();
     pFont_ = FontManager::GetSingleton()->GetFont(sFileName_, uint_t(fSize_));
     if (pFont_)
     {
@@ -239,6 +237,14 @@ float Text::GetCharacterKerning( const uint_t& uiChar1, const uint_t& uiChar2 )
     return pFont_->GetCharacterKerning(uchar_t(uiChar1), uchar_t(uiChar2));
 }
 
+float Text::GetDisplayKerning_( char cChar1, char cChar2 ) const
+{
+    if (cChar1 == ' ' || cChar2 == ' ')
+        return 0.0f;
+
+    return GetCharacterKerning((uint_t)cChar1, (uint_t)cChar2);
+}
+
 void Text::SetAlignment( const Text::Alignment& mAlign )
 {
     if (mAlign_ != mAlign)
@@ -315,54 +321,35 @@ void Text::Render( float fX, float fY )
     {
         Update();
 
-        if (fX != fX_ || fY != fY_)
-            bUpdateQuads_ = true;
-
+        // Quads are built relative to the top left corner : moving
+        // the text only changes the transform
         if (bUpdateQuads_)
         {
-            fX_ = fX;
-            fY_ = fY;
-
-            lQuadList_.clear();
-
-            sf::Sprite mSprite;
-            mSprite.setTexture(*pFont_->GetTexture());
+            mQuads_.clear();
+            mQuads_.setPrimitiveType(sf::Quads);
 
             for (auto& mLetter : lLetterCache_)
             {
-                mSprite.setPosition((mLetter.fX1+fX), (mLetter.fY1+fY));
-                mSprite.setTextureRect(sf::IntRect(
-                    mLetter.iU1, mLetter.iV1, mLetter.iU2 - mLetter.iU1, mLetter.iV2 - mLetter.iV1
-                ));
+                const Color& mLetterColor = (!mLetter.mColor.IsNaN() && !bForceColor_) ? mLetter.mColor : mColor_;
+                sf::Color mColor(mLetterColor.GetR(), mLetterColor.GetG(), mLetterColor.GetB(), mLetterColor.GetA());
 
-                if (!mLetter.mColor.IsNaN() && !bForceColor_)
-                {
-                    mSprite.setColor(sf::Color(
-                        mLetter.mColor.GetR(),
-                        mLetter.mColor.GetG(),
-                        mLetter.mColor.GetB(),
-                        mLetter.mColor.GetA()
-                    ));
-                }
-                else
-                {
-                    mSprite.setColor(sf::Color(
-                        mColor_.GetR(),
-                        mColor_.GetG(),
-                        mColor_.GetB(),
-                        mColor_.GetA()
-                    ));
-                }
+                float fX2 = mLetter.fX1 + (mLetter.iU2 - mLetter.iU1);
+                float fY2 = mLetter.fY1 + (mLetter.iV2 - mLetter.iV1);
 
-                lQuadList_.push_back(mSprite);
+                mQuads_.append(sf::Vertex(sf::Vector2f(mLetter.fX1, mLetter.fY1), mColor, sf::Vector2f(mLetter.iU1, mLetter.iV1)));
+                mQuads_.append(sf::Vertex(sf::Vector2f(fX2,         mLetter.fY1), mColor, sf::Vector2f(mLetter.iU2, mLetter.iV1)));
+                mQuads_.append(sf::Vertex(sf::Vector2f(fX2,         fY2),         mColor, sf::Vector2f(mLetter.iU2, mLetter.iV2)));
+                mQuads_.append(sf::Vertex(sf::Vector2f(mLetter.fX1, fY2),         mColor, sf::Vector2f(mLetter.iU1, mLetter.iV2)));
             }
 
             bUpdateQuads_ = false;
         }
 
-        for (auto& mQuad : lQuadList_)
+        if (mQuads_.getVertexCount() != 0)
         {
-            Application::GetMainApp()->GetRenderWindow()->draw(mQuad);
+            sf::RenderStates mStates(pFont_->GetTexture());
+            mStates.transform.translate(fX, fY);
+            Application::GetMainApp()->Draw(mQuads_, mStates);
         }
     }
 }
@@ -456,20 +443,15 @@ void Text::UpdateLines_()
                         break;
                 }
 
+                // Kern against the previous displayed character : format tags are not in the caption
+                if (!mLine.sCaption.empty())
+                    mLine.fWidth += GetDisplayKerning_(mLine.sCaption.back(), *iterChar1);
+
                 if (*iterChar1 == ' ')
                     mLine.fWidth += fSpaceWidth_;
                 else
-                {
-
                     mLine.fWidth += GetCharacterWidth(*iterChar1);
-                    //Log("2 : "+mLine.fWidth);
-                    /*std::string::iterator iterNext = iterChar1 + 1;
-                    if (iterNext != sLine.end())
-                    {
-                        if (*iterNext != ' ')
-                            mLine.fWidth += GetCharacterKerning((uint_t)*iterChar1, (uint_t)*iterNext);
-                    }*/
-                }
+
                 mLine.sCaption += *iterChar1;
 
                 if (mLine.fWidth > fBoxW_)
@@ -754,18 +736,18 @@ void Text::UpdateCache_()
                 }
                 else
                 {
-                    std::array<float,4> lUVs = pFont_->GetCharacterUVs(*iterChar);
-                    fCharWidth = GetCharacterWidth((uint_t)*iterChar);
-                    fCharHeight = (lUVs[3] - lUVs[1])*pFont_->GetTextureHeight();
+                    const sf::IntRect& mRect = pFont_->GetCharacterRect(uchar_t(*iterChar));
+                    fCharWidth = mRect.width;
+                    fCharHeight = mRect.height;
                     float fYOffset = fSize_/2 - fCharHeight/2;
 
                     mLetter.fX1 = fX;            mLetter.fY1 = fY+fYOffset;
                     mLetter.fX2 = fX+fCharWidth; mLetter.fY2 = fY+fYOffset+fCharHeight;
 
-                    mLetter.iU1 = int(lUVs[0]*pFont_->GetTextureWidth());
-                    mLetter.iV1 = int(lUVs[1]*pFont_->GetTextureHeight());
-                    mLetter.iU2 = int(lUVs[2]*pFont_->GetTextureWidth());
-                    mLetter.iV2 = int(lUVs[3]*pFont_->GetTextureHeight());
+                    mLetter.iU1 = mRect.left;
+                    mLetter.iV1 = mRect.top;
+                    mLetter.iU2 = mRect.left + mRect.width;
+                    mLetter.iV2 = mRect.top + mRect.height;
 
                     mLetter.mColor = mColor;
 
@@ -774,13 +756,8 @@ void Text::UpdateCache_()
 
                 iterNext = iterChar + 1;
                 float fKerning = 0.0f;
-                /*if (iterNext != mLine.sCaption.end())
-                {
-                    if (*iterNext != ' ' && *iterChar != ' ')
-                    {
-                        fKerning = GetCharacterKerning((uint_t)*iterChar, (uint_t)*iterNext);
-                    }
-                }*/
+                if (iterNext != mLine.sCaption.end())
+                    fKerning = GetDisplayKerning_(*iterChar, *iterNext);
 
                 fX += fCharWidth + fKerning + fTracking_;
                 ++uiCounter;
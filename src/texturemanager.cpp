@@ -1,4 +1,7 @@
 #include "texturemanager.h"
+#include "log.h"
+
+#include <algorithm>
 
 const std::string TextureManager::CLASS_NAME = "TextureManager";
 
@@ -27,3 +30,103 @@ sf::Texture* TextureManager::LoadTexture( const std::string& sFile )
 
     return iter->second.get();
 }
+
+void TextureManager::PackAtlas(const std::vector<std::string>& lFileList)
+{
+    struct Image
+    {
+        std::string sFile;
+        sf::Image   mImage;
+    };
+
+    std::vector<Image> lImageList(lFileList.size());
+    for (uint_t i = 0; i < lFileList.size(); ++i)
+    {
+        lImageList[i].sFile = lFileList[i];
+        if (!lImageList[i].mImage.loadFromFile(lFileList[i]))
+            throw std::runtime_error(CLASS_NAME+" : Unable to load Texture : "+lFileList[i]);
+    }
+
+    std::stable_sort(lImageList.begin(), lImageList.end(), [](const Image& mImage1, const Image& mImage2) {
+        return mImage1.mImage.getSize().y > mImage2.mImage.getSize().y;
+    });
+
+    uint_t uiSize = std::min(uint_t(sf::Texture::getMaximumSize()), ATLAS_SIZE);
+
+    sf::Image mAtlas;
+    std::vector<std::pair<std::string, sf::IntRect>> lPlacedList;
+    uint_t uiX = 0, uiY = 0, uiRowHeight = 0;
+
+    auto mFlush = [&]() {
+        if (lPlacedList.empty())
+            return;
+
+        lAtlasList_.push_back(std::unique_ptr<sf::Texture>(new sf::Texture()));
+        sf::Texture* pTexture = lAtlasList_.back().get();
+        pTexture->loadFromImage(mAtlas, sf::IntRect(0, 0, uiSize, uiY + uiRowHeight));
+
+        for (auto& mPlaced : lPlacedList)
+        {
+            TextureRegion& mRegion = lRegionList_[mPlaced.first];
+            mRegion.pTexture = pTexture;
+            mRegion.mRect = mPlaced.second;
+        }
+
+        lPlacedList.clear();
+        uiX = uiY = uiRowHeight = 0;
+    };
+
+    for (auto& mImage : lImageList)
+    {
+        uint_t uiW = mImage.mImage.getSize().x, uiH = mImage.mImage.getSize().y;
+        if (uiW > uiSize || uiH > uiSize)
+        {
+            // Too large for an atlas : use its own texture
+            LoadRegion(mImage.sFile);
+            continue;
+        }
+
+        if (uiX + uiW > uiSize)
+        {
+            // Start a new row
+            uiX = 0;
+            uiY += uiRowHeight + ATLAS_PADDING;
+            uiRowHeight = 0;
+        }
+
+        if (uiY + uiH > uiSize)
+            mFlush();
+
+        if (lPlacedList.empty())
+            mAtlas.create(uiSize, uiSize, sf::Color::Transparent);
+
+        mAtlas.copy(mImage.mImage, uiX, uiY);
+        lPlacedList.push_back(std::make_pair(mImage.sFile, sf::IntRect(uiX, uiY, uiW, uiH)));
+
+        uiX += uiW + ATLAS_PADDING;
+        uiRowHeight = std::max(uiRowHeight, uiH);
+    }
+
+    mFlush();
+
+    Log("Packed "+ToString(lFileList.size())+" images in "+ToString(lAtlasList_.size())+" atlas texture(s).");
+}
+
+const TextureRegion& TextureManager::LoadRegion(const std::string& sFile)
+{
+    auto iter = lRegionList_.find(sFile);
+    if (iter == lRegionList_.end())
+    {
+        TextureRegion mRegion;
+        mRegion.pTexture = LoadTexture(sFile);
+        mRegion.mRect = sf::IntRect(0, 0, mRegion.pTexture->getSize().x, mRegion.pTexture->getSize().y);
+        iter = lRegionList_.insert(std::make_pair(sFile, mRegion)).first;
+    }
+
+    return iter->second;
+}
+
+uint_t TextureManager::GetAtlasCount() const
+{
+    return lAtlasList_.size();
+}
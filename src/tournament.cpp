@@ -0,0 +1,355 @@
+#include "aiplayer.h"
+#include "mctsplayer.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace
+{
+    /// How to create one of the engines, from a description like "alphabeta:time=0.1,depth=8"
+    struct EngineConfig
+    {
+        std::string sDescription;
+        std::string sType;
+        float  fTime = 0.1f;
+        uint_t uiThreads = 1;
+        uint_t uiDepth = 64;
+        uint_t uiHashMB = 16;
+        float  fExploration = 0.7f;
+        uint_t uiPlayoutLength = 16;
+        float  fRandomness = 0.2f;
+    };
+
+    struct EngineStats
+    {
+        uint64_t uiMoves = 0;
+        uint64_t uiNodes = 0;
+        double   dTime = 0.0;
+    };
+
+    struct GameResult
+    {
+        uint_t uiOpening = 0;
+        /// The engine playing player 1 (0 for the first engine, 1 for the second)
+        uint_t uiFirstEngine = 0;
+        /// The engine who won (npos for a draw : the game was too long)
+        uint_t uiWinner = npos;
+        uint_t uiPlies = 0;
+        std::array<EngineStats, 2> lStatsList;
+    };
+
+    struct Settings
+    {
+        std::array<EngineConfig, 2> lEngineList;
+        uint_t uiGames = 100;
+        uint_t uiJobs = std::max(std::thread::hardware_concurrency(), 1u);
+        uint_t uiOpeningPlies = 4;
+        uint_t uiMaxPlies = 600;
+        uint_t uiSeed = 1;
+        std::string sCSVFile;
+        std::string sDetailsFile;
+    };
+
+    bool ParseEngine(const std::string& sDescription, EngineConfig& mConfig)
+    {
+        mConfig = EngineConfig();
+        mConfig.sDescription = sDescription;
+
+        std::string::size_type uiPos = sDescription.find(':');
+        mConfig.sType = sDescription.substr(0, uiPos);
+        if (mConfig.sType != "alphabeta" && mConfig.sType != "mcts")
+            return false;
+
+        if (uiPos == std::string::npos)
+            return true;
+
+        for (auto& sOption : SplitEach(sDescription.substr(uiPos + 1), ","))
+        {
+            std::string::size_type uiEqual = sOption.find('=');
+            if (uiEqual == std::string::npos)
+                return false;
+
+            std::string sName = sOption.substr(0, uiEqual);
+            const char* sValue = sOption.c_str() + uiEqual + 1;
+
+            if (sName == "time")             mConfig.fTime = std::atof(sValue);
+            else if (sName == "threads")     mConfig.uiThreads = std::atoi(sValue);
+            else if (sName == "depth")       mConfig.uiDepth = std::atoi(sValue);
+            else if (sName == "hash")        mConfig.uiHashMB = std::atoi(sValue);
+            else if (sName == "exploration") mConfig.fExploration = std::atof(sValue);
+            else if (sName == "playout")     mConfig.uiPlayoutLength = std::atoi(sValue);
+            else if (sName == "randomness")  mConfig.fRandomness = std::atof(sValue);
+            else
+                return false;
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<ComputerPlayer> CreateEngine(const EngineConfig& mConfig)
+    {
+        std::unique_ptr<ComputerPlayer> pEngine;
+        if (mConfig.sType == "alphabeta")
+        {
+            AIPlayer* pAI = new AIPlayer();
+            pAI->SetMaxDepth(mConfig.uiDepth);
+            pAI->SetHashSize(mConfig.uiHashMB);
+            pEngine = std::unique_ptr<ComputerPlayer>(pAI);
+        }
+        else
+        {
+            MCTSPlayer* pMCTS = new MCTSPlayer();
+            pMCTS->SetExploration(mConfig.fExploration);
+            pMCTS->SetPlayoutLength(mConfig.uiPlayoutLength);
+            pMCTS->SetRandomness(mConfig.fRandomness);
+            pEngine = std::unique_ptr<ComputerPlayer>(pMCTS);
+        }
+
+        pEngine->SetTimeBudget(mConfig.fTime);
+        pEngine->SetThreadCount(mConfig.uiThreads);
+        return pEngine;
+    }
+
+    /// Plays a game from a random opening.
+    /** \note Games are played in pairs on the same opening, each engine playing first once.
+    */
+    void PlayGame(const Settings& mSettings, uint_t uiGame, GameResult& mResult)
+    {
+        mResult.uiOpening = uiGame/2;
+        mResult.uiFirstEngine = uiGame % 2;
+
+        GameState mGame;
+        std::vector<Move> lMoveList;
+        std::mt19937 mRandom(mSettings.uiSeed*1000003u + mResult.uiOpening);
+        for (uint_t i = 0; i < mSettings.uiOpeningPlies && !mGame.IsOver(); ++i)
+        {
+            mGame.GenerateMoves(lMoveList);
+
+            // No legal move : the player passes
+            if (lMoveList.empty())
+                mGame.EndTurn();
+            else
+                mGame.PlayMove(lMoveList[mRandom() % lMoveList.size()]);
+
+            ++mResult.uiPlies;
+        }
+
+        // New engines for each game : nothing is learned from the previous one
+        std::array<std::unique_ptr<ComputerPlayer>, 2> lEngineList = {{
+            CreateEngine(mSettings.lEngineList[0]), CreateEngine(mSettings.lEngineList[1])
+        }};
+
+        while (!mGame.IsOver() && mResult.uiPlies < mSettings.uiMaxPlies)
+        {
+            uint_t uiEngine = mGame.GetPlayer() == 0 ? mResult.uiFirstEngine : 1 - mResult.uiFirstEngine;
+            ComputerPlayer& mEngine = *lEngineList[uiEngine];
+
+            Move mMove = mEngine.Search(mGame);
+
+            const SearchInfo& mInfo = mEngine.GetLastSearchInfo();
+            EngineStats& mStats = mResult.lStatsList[uiEngine];
+            ++mStats.uiMoves;
+            mStats.uiNodes += mInfo.uiNodes;
+            mStats.dTime += mInfo.fTime;
+
+            // No move found : the player passes
+            if (mMove == Move())
+                mGame.EndTurn();
+            else
+                mGame.PlayMove(mMove);
+
+            ++mResult.uiPlies;
+        }
+
+        if (mGame.GetState() == GameState::STATE_VICTORY1)
+            mResult.uiWinner = mResult.uiFirstEngine;
+        else if (mGame.GetState() == GameState::STATE_VICTORY2)
+            mResult.uiWinner = 1 - mResult.uiFirstEngine;
+    }
+
+    /// Converts a score (between 0 and 1) to an Elo difference.
+    double ToElo(double dScore)
+    {
+        dScore = Clamp(dScore, 0.001, 0.999);
+        return -400.0*std::log10(1.0/dScore - 1.0);
+    }
+
+    std::string Quote(const std::string& sField)
+    {
+        return "\""+Replace(sField, "\"", "\"\"")+"\"";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Settings mSettings;
+    ParseEngine("alphabeta", mSettings.lEngineList[0]);
+    ParseEngine("mcts", mSettings.lEngineList[1]);
+
+    for (int i = 1; i < argc; ++i)
+    {
+        bool bValid = true;
+        if (std::strcmp(argv[i], "--engine1") == 0 && i + 1 < argc)
+            bValid = ParseEngine(argv[++i], mSettings.lEngineList[0]);
+        else if (std::strcmp(argv[i], "--engine2") == 0 && i + 1 < argc)
+            bValid = ParseEngine(argv[++i], mSettings.lEngineList[1]);
+        else if (std::strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+            mSettings.uiGames = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+            mSettings.uiJobs = std::max(std::atoi(argv[++i]), 1);
+        else if (std::strcmp(argv[i], "--opening") == 0 && i + 1 < argc)
+            mSettings.uiOpeningPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--max-plies") == 0 && i + 1 < argc)
+            mSettings.uiMaxPlies = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            mSettings.uiSeed = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            mSettings.sCSVFile = argv[++i];
+        else if (std::strcmp(argv[i], "--details") == 0 && i + 1 < argc)
+            mSettings.sDetailsFile = argv[++i];
+        else
+            bValid = false;
+
+        if (!bValid)
+        {
+            std::cout << "Usage : orb_tournament [--engine1 spec] [--engine2 spec] [--games N] [--jobs N]\n"
+                "                      [--opening plies] [--max-plies N] [--seed N] [--csv file] [--details file]\n"
+                "Engine spec : alphabeta[:time=s,threads=N,depth=N,hash=MB]\n"
+                "              mcts[:time=s,threads=N,exploration=x,playout=N,randomness=x]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Engine 1 : " << mSettings.lEngineList[0].sDescription << std::endl
+        << "Engine 2 : " << mSettings.lEngineList[1].sDescription << std::endl
+        << "Playing " << mSettings.uiGames << " games on " << mSettings.uiJobs << " threads" << std::endl;
+
+    // Each thread takes the next game to play, until all are played
+    std::vector<GameResult> lResultList(mSettings.uiGames);
+    std::atomic<uint_t> uiNextGame(0);
+    std::mutex mOutputMutex;
+    uint_t uiFinished = 0;
+
+    auto mStart = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> lThreadList;
+    for (uint_t i = 0; i < std::min(mSettings.uiJobs, mSettings.uiGames); ++i)
+    {
+        lThreadList.push_back(std::thread([&]() {
+            uint_t uiGame;
+            while ((uiGame = uiNextGame++) < mSettings.uiGames)
+            {
+                GameResult& mResult = lResultList[uiGame];
+                PlayGame(mSettings, uiGame, mResult);
+
+                std::lock_guard<std::mutex> mLock(mOutputMutex);
+                ++uiFinished;
+                std::cout << "[" << std::setw(4) << uiFinished << "/" << mSettings.uiGames << "] game "
+                    << uiGame << " : " << (mResult.uiWinner == npos ? "draw" :
+                        "engine "+ToString(mResult.uiWinner + 1)+" wins")
+                    << " in " << mResult.uiPlies << " plies" << std::endl;
+            }
+        }));
+    }
+
+    for (auto& mThread : lThreadList)
+        mThread.join();
+
+    double dTotalTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count();
+
+    // Score of the first engine : 1 for a win, 0.5 for a draw
+    uint_t uiWins = 0, uiDraws = 0, uiLosses = 0;
+    uint64_t uiPlies = 0;
+    std::array<EngineStats, 2> lStatsList;
+    for (auto& mResult : lResultList)
+    {
+        if (mResult.uiWinner == 0)
+            ++uiWins;
+        else if (mResult.uiWinner == 1)
+            ++uiLosses;
+        else
+            ++uiDraws;
+
+        uiPlies += mResult.uiPlies;
+        for (uint_t e = 0; e < 2; ++e)
+        {
+            lStatsList[e].uiMoves += mResult.lStatsList[e].uiMoves;
+            lStatsList[e].uiNodes += mResult.lStatsList[e].uiNodes;
+            lStatsList[e].dTime += mResult.lStatsList[e].dTime;
+        }
+    }
+
+    double dGames = double(mSettings.uiGames);
+    double dScore = (uiWins + 0.5*uiDraws)/dGames;
+    double dVariance = (uiWins + 0.25*uiDraws)/dGames - dScore*dScore;
+    double dMargin = 1.96*std::sqrt(std::max(dVariance, 0.0)/dGames);
+
+    std::array<double, 2> lNodesPerSecond, lTimePerMove;
+    for (uint_t e = 0; e < 2; ++e)
+    {
+        lNodesPerSecond[e] = lStatsList[e].dTime > 0.0 ? lStatsList[e].uiNodes/lStatsList[e].dTime : 0.0;
+        lTimePerMove[e] = lStatsList[e].uiMoves ? 1000.0*lStatsList[e].dTime/lStatsList[e].uiMoves : 0.0;
+    }
+
+    std::cout << std::endl << std::fixed << std::setprecision(1)
+        << "Engine 1 : " << uiWins << " wins, " << uiDraws << " draws, " << uiLosses << " losses" << std::endl
+        << "Score    : " << 100.0*dScore << "% +/- " << 100.0*dMargin << "% (95% confidence), Elo "
+        << ToElo(dScore) << " [" << ToElo(dScore - dMargin) << ", " << ToElo(dScore + dMargin) << "]" << std::endl
+        << "Length   : " << uiPlies/dGames << " plies per game, " << dTotalTime << " s in all" << std::endl;
+
+    for (uint_t e = 0; e < 2; ++e)
+    {
+        std::cout << std::setprecision(0) << "Engine " << e + 1 << " : " << lNodesPerSecond[e] << " nodes/s, "
+            << std::setprecision(1) << lTimePerMove[e] << " ms per move" << std::endl;
+    }
+
+    if (!mSettings.sDetailsFile.empty())
+    {
+        std::ofstream mFile(mSettings.sDetailsFile);
+        mFile << "game,opening,first_engine,winner,plies,moves1,nodes1,time1,moves2,nodes2,time2\n";
+        for (uint_t i = 0; i < lResultList.size(); ++i)
+        {
+            const GameResult& mResult = lResultList[i];
+            mFile << i << "," << mResult.uiOpening << "," << mResult.uiFirstEngine + 1 << ","
+                << (mResult.uiWinner == npos ? 0 : mResult.uiWinner + 1) << "," << mResult.uiPlies;
+            for (auto& mStats : mResult.lStatsList)
+                mFile << "," << mStats.uiMoves << "," << mStats.uiNodes << "," << mStats.dTime;
+            mFile << "\n";
+        }
+    }
+
+    if (!mSettings.sCSVFile.empty())
+    {
+        // One line per run, appended so that the results can be followed over time
+        bool bNewFile = !FileExists(mSettings.sCSVFile);
+        std::ofstream mFile(mSettings.sCSVFile, std::ios::app);
+        if (bNewFile)
+        {
+            mFile << "date,engine1,engine2,games,wins1,draws,wins2,score1,margin95,elo,elo_low,elo_high,"
+                "plies_per_game,nodes_per_second1,nodes_per_second2,ms_per_move1,ms_per_move2\n";
+        }
+
+        char sDate[32];
+        std::time_t mTime = std::time(nullptr);
+        std::strftime(sDate, sizeof(sDate), "%Y-%m-%d %H:%M:%S", std::localtime(&mTime));
+
+        mFile << std::fixed << std::setprecision(4) << sDate << ","
+            << Quote(mSettings.lEngineList[0].sDescription) << "," << Quote(mSettings.lEngineList[1].sDescription) << ","
+            << mSettings.uiGames << "," << uiWins << "," << uiDraws << "," << uiLosses << ","
+            << dScore << "," << dMargin << "," << ToElo(dScore) << "," << ToElo(dScore - dMargin) << ","
+            << ToElo(dScore + dMargin) << "," << uiPlies/dGames << ","
+            << lNodesPerSecond[0] << "," << lNodesPerSecond[1] << "," << lTimePerMove[0] << "," << lTimePerMove[1] << "\n";
+    }
+
+    return 0;
+}
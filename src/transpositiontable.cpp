@@ -0,0 +1,109 @@
+#include "transpositiontable.h"
+
+#include <algorithm>
+
+// Layout of the packed data :
+//  - bits  0-31 : score
+//  - bits 32-39 : depth
+//  - bits 40-41 : bound
+//  - bits 42-47 : generation
+//  - bits 48-63 : move (from, to)
+namespace
+{
+    const uint_t   GENERATION_COUNT = 64;
+    const uint64_t GENERATION_MASK = GENERATION_COUNT - 1;
+}
+
+TranspositionTable::TranspositionTable(uint_t uiSizeMB)
+{
+    Resize(uiSizeMB);
+}
+
+void TranspositionTable::Resize(uint_t uiSizeMB)
+{
+    uint64_t uiCount = (uint64_t(std::max(uiSizeMB, uint_t(1))) << 20)/sizeof(Bucket_);
+
+    uint64_t uiPower = 1;
+    while (2*uiPower <= uiCount)
+        uiPower *= 2;
+
+    lBucketList_ = std::unique_ptr<Bucket_[]>(new Bucket_[uiPower]);
+    uiMask_ = uiPower - 1;
+
+    Clear();
+}
+
+void TranspositionTable::Clear()
+{
+    for (uint64_t i = 0; i <= uiMask_; ++i)
+    {
+        lBucketList_[i].uiKey.store(0, std::memory_order_relaxed);
+        lBucketList_[i].uiData.store(0, std::memory_order_relaxed);
+    }
+
+    uiGeneration_ = 0;
+}
+
+void TranspositionTable::NewSearch()
+{
+    uiGeneration_ = (uiGeneration_ + 1) % GENERATION_COUNT;
+}
+
+bool TranspositionTable::Probe(uint64_t uiHash, TranspositionEntry& mEntry) const
+{
+    const Bucket_& mBucket = lBucketList_[uiHash & uiMask_];
+    uint64_t uiKey  = mBucket.uiKey.load(std::memory_order_relaxed);
+    uint64_t uiData = mBucket.uiData.load(std::memory_order_relaxed);
+
+    if ((uiKey ^ uiData) != uiHash)
+        return false;
+
+    mEntry = Unpack_(uiData);
+    return mEntry.mBound != TranspositionEntry::BOUND_NONE;
+}
+
+void TranspositionTable::Store(uint64_t uiHash, const TranspositionEntry& mEntry)
+{
+    Bucket_& mBucket = lBucketList_[uiHash & uiMask_];
+    uint64_t uiKey  = mBucket.uiKey.load(std::memory_order_relaxed);
+    uint64_t uiData = mBucket.uiData.load(std::memory_order_relaxed);
+
+    // Keep the results of deeper searches of other positions, unless they are outdated
+    if ((uiKey ^ uiData) != uiHash && GetGeneration_(uiData) == uiGeneration_ &&
+        Unpack_(uiData).uiDepth > mEntry.uiDepth)
+        return;
+
+    uiData = Pack_(mEntry, uiGeneration_);
+    mBucket.uiKey.store(uiHash ^ uiData, std::memory_order_relaxed);
+    mBucket.uiData.store(uiData, std::memory_order_relaxed);
+}
+
+uint_t TranspositionTable::GetSize() const
+{
+    return uiMask_ + 1;
+}
+
+uint64_t TranspositionTable::Pack_(const TranspositionEntry& mEntry, uint_t uiGeneration)
+{
+    return uint64_t(uint32_t(mEntry.iScore)) |
+        (uint64_t(std::min(mEntry.uiDepth, uint_t(255))) << 32) |
+        (uint64_t(mEntry.mBound) << 40) |
+        (uint64_t(uiGeneration & GENERATION_MASK) << 42) |
+        (uint64_t(mEntry.mMove.uiFrom) << 48) |
+        (uint64_t(mEntry.mMove.uiTo) << 56);
+}
+
+TranspositionEntry TranspositionTable::Unpack_(uint64_t uiData)
+{
+    TranspositionEntry mEntry;
+    mEntry.iScore = int32_t(uint32_t(uiData));
+    mEntry.uiDepth = (uiData >> 32) & 0xFF;
+    mEntry.mBound = (TranspositionEntry::Bound)((uiData >> 40) & 3);
+    mEntry.mMove = Move((uiData >> 48) & 0xFF, (uiData >> 56) & 0xFF);
+    return mEntry;
+}
+
+uint_t TranspositionTable::GetGeneration_(uint64_t uiData)
+{
+    return (uiData >> 42) & GENERATION_MASK;
+}
@@ -6,12 +6,49 @@
 #include <vector>
 #include <string>
 
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstdio>
+#ifdef WIN32
+#include <direct.h>
+#include <windows.h>
+#endif
+
 bool FileExists(const std::string& sFilename)
 {
     std::ifstream mFile(sFilename);
     return mFile.is_open();
 }
 
+long long GetFileTime(const std::string& sFilename)
+{
+    struct stat mStat;
+    if (stat(sFilename.c_str(), &mStat) != 0)
+        return 0;
+
+    return mStat.st_mtime;
+}
+
+bool MakeDirectory(const std::string& sDirectory)
+{
+#ifdef WIN32
+    int iResult = _mkdir(sDirectory.c_str());
+#else
+    int iResult = mkdir(sDirectory.c_str(), 0755);
+#endif
+    return iResult == 0 || errno == EEXIST;
+}
+
+bool ReplaceFile(const std::string& sSource, const std::string& sDestination)
+{
+#ifdef WIN32
+    // rename() doesn't overwrite on Windows
+    return MoveFileExA(sSource.c_str(), sDestination.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(sSource.c_str(), sDestination.c_str()) == 0;
+#endif
+}
+
 uint_t HexToUInt(const std::string& sStr)
 {
     uint_t i;
@@ -0,0 +1,47 @@
+#include "zobrist.h"
+
+namespace
+{
+    /// Keys, built on first use.
+    struct Keys
+    {
+        Keys()
+        {
+            // SplitMix64 generator
+            uint64_t uiState = 0x4f7262ull;
+            auto mNext = [&]() {
+                uint64_t uiValue = (uiState += 0x9e3779b97f4a7c15ull);
+                uiValue = (uiValue ^ (uiValue >> 30))*0xbf58476d1ce4e5b9ull;
+                uiValue = (uiValue ^ (uiValue >> 27))*0x94d049bb133111ebull;
+                return uiValue ^ (uiValue >> 31);
+            };
+
+            for (uint_t c = 0; c < 4; ++c)
+            {
+                for (uint_t i = 0; i < BitBoard::SIZE; ++i)
+                    lOrbKeyList[c][i] = mNext();
+            }
+
+            uiPlayerKey = mNext();
+        }
+
+        std::array<std::array<uint64_t, BitBoard::SIZE>, 4> lOrbKeyList;
+        uint64_t uiPlayerKey;
+    };
+
+    const Keys& GetKeys()
+    {
+        static const Keys mKeys;
+        return mKeys;
+    }
+}
+
+uint64_t Zobrist::GetOrbKey(uint_t uiColor, uint_t uiIndex)
+{
+    return GetKeys().lOrbKeyList[uiColor][uiIndex];
+}
+
+uint64_t Zobrist::GetPlayerKey()
+{
+    return GetKeys().uiPlayerKey;
+}